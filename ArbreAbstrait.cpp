@@ -3,14 +3,33 @@
 #include "Symbole.h"
 #include "SymboleValue.h"
 #include "Exceptions.h"
+#include "ArbrePlat.h"
+#include "Operations.h"
+#include "Optimiseur.h"
 #include <vector>
-#include <typeinfo>
 using namespace std;
+////////////////////////////////////////////////////////////////////////////////
+// Noeud
+////////////////////////////////////////////////////////////////////////////////
+
+const char* nomGenre(Genre genre) {
+    switch (genre) {
+#define X(genre, classe) case Genre::genre: return #classe;
+        GENRES(X)
+#undef X
+    }
+    return "?";
+}
+
+uint32_t Noeud::aplatir(ArbrePlat & plat) {
+    return plat.ajouterExterne(this);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // NoeudSeqInst
 ////////////////////////////////////////////////////////////////////////////////
 
-NoeudSeqInst::NoeudSeqInst() : m_instructions() {
+NoeudSeqInst::NoeudSeqInst() : Noeud(Genre::SEQUENCE), m_instructions() {
 }
 
 int NoeudSeqInst::executer() {
@@ -23,14 +42,51 @@ void NoeudSeqInst::ajoute(Noeud* instruction) {
     if (instruction != nullptr) m_instructions.push_back(instruction);
 }
 
+Noeud* NoeudSeqInst::resoudre(Cadre & cadre, Arene & arene) {
+    for (auto & instr : m_instructions) instr = instr->resoudre(cadre, arene);
+    return this;
+}
+
+Noeud* NoeudSeqInst::optimiser(Optimiseur & optimiseur) {
+    vector<Noeud *> instructions;
+    vector<bool> sures; // pour chaque instruction gardée : est-ce une affectation qui ne peut pas échouer ?
+    vector<Optimiseur::Disponible> disponibles; // les valeurs calculées par la suite d'affectations en cours
+    for (auto instr : m_instructions) {
+        bool sure = instr->getGenre() == Genre::AFFECTATION // ou l'une de ses formes spécialisées
+                && optimiseur.estSur(((NoeudAffectation *) instr)->getExpression()); // avant qu'elle ne définisse sa variable
+        Noeud* optimisee = optimiseur.optimiserFils(instr);
+        if (optimisee->getGenre() == Genre::SEQUENCE) { // ce qui reste d'un si supprimé, ou une boucle et ses invariants
+            vector<Noeud *> & sequence = ((NoeudSeqInst *) optimisee)->m_instructions;
+            instructions.insert(instructions.end(), sequence.begin(), sequence.end());
+            sures.resize(instructions.size(), false);
+            disponibles.clear();
+        } else {
+            instructions.push_back(optimisee);
+            sures.push_back(sure); // une affectation optimisée reste une affectation, de la même valeur
+            optimiseur.partagerCommunes(instructions, sures, disponibles);
+        }
+    }
+    optimiseur.eliminerAffectationsMortes(instructions, sures);
+    m_instructions = move(instructions);
+    return this;
+}
+
+void NoeudSeqInst::parcourirFils(const function<void(Noeud*)> & action) const {
+    for (auto instr : m_instructions) action(instr);
+}
+
+uint32_t NoeudSeqInst::aplatir(ArbrePlat & plat) {
+    vector<uint32_t> fils;
+    for (auto instr : m_instructions) fils.push_back(instr->aplatir(plat));
+    return plat.ajouterListe(P_SEQUENCE, fils);
+}
+
 void NoeudSeqInst::traduitEnCPP(ostream& cout, unsigned int indentation) const {
     for (auto instr : m_instructions) {
         instr->traduitEnCPP(cout, indentation);
-        if ((typeid (*instr) == typeid (NoeudAffectation*))
-                || (typeid (*instr) == typeid (NoeudInstRepeter*))
-                || (typeid (*instr) == typeid (NoeudInstEcrire*))
-                || (typeid (*instr) == typeid (NoeudInstLire*))) {
-            cout << ";";
+        Genre genre = instr->getGenre();
+        if (genre == Genre::AFFECTATION || genre == Genre::ECRIRE || genre == Genre::LIRE) {
+            cout << ";"; // les instructions composées se terminent par } ou par ;
         }
         cout << endl;
     }
@@ -45,15 +101,39 @@ void NoeudSeqInst::traduitEnCPP(ostream& cout, unsigned int indentation) const {
 ////////////////////////////////////////////////////////////////////////////////
 
 NoeudAffectation::NoeudAffectation(Noeud* variable, Noeud* expression)
-: m_variable(variable), m_expression(expression) {
+: Noeud(Genre::AFFECTATION), m_variable(variable), m_expression(expression) {
 }
 
 int NoeudAffectation::executer() {
     int valeur = m_expression->executer(); // On exécute (évalue) l'expression
-    ((SymboleValue*) m_variable)->setValeur(valeur); // On affecte la variable
+    m_variable->affecter(valeur); // On affecte la variable
     return 0; // La valeur renvoyée ne représente rien !
 }
 
+Noeud* NoeudAffectation::resoudre(Cadre & cadre, Arene & arene) {
+    m_variable = m_variable->resoudre(cadre, arene);
+    m_expression = m_expression->resoudre(cadre, arene);
+    return specialiserAffectation(this, arene); // superinstruction si l'expression est une opération spécialisable
+}
+
+Noeud* NoeudAffectation::optimiser(Optimiseur & optimiseur) {
+    Noeud* expression = optimiseur.optimiserExpression(m_expression);
+    // nouvelle affectation (une superinstruction garde ses opérandes), créée avant que la variable ne change
+    Noeud* affectation = expression == m_expression ? this : optimiseur.affectation(m_variable, expression);
+    optimiseur.definir(m_variable, expression);
+    return affectation;
+}
+
+void NoeudAffectation::parcourirFils(const function<void(Noeud*)> & action) const {
+    action(m_variable);
+    action(m_expression);
+}
+
+uint32_t NoeudAffectation::aplatir(ArbrePlat & plat) {
+    uint32_t variable = m_variable->aplatir(plat);
+    return plat.ajouter(P_AFFECTATION, variable, m_expression->aplatir(plat));
+}
+
 void NoeudAffectation::traduitEnCPP(std::ostream& cout, unsigned int indentation) const {
     cout << setw(4 * indentation) << "";
     m_variable->traduitEnCPP(cout, 0);
@@ -67,38 +147,139 @@ void NoeudAffectation::traduitEnCPP(std::ostream& cout, unsigned int indentation
 ////////////////////////////////////////////////////////////////////////////////
 
 NoeudOperateurBinaire::NoeudOperateurBinaire(Symbole operateur, Noeud* operandeGauche, Noeud* operandeDroit)
-: m_operateur(operateur), m_operandeGauche(operandeGauche), m_operandeDroit(operandeDroit) {
+: Noeud(Genre::OPERATION), m_operateur(operateur), m_operandeGauche(operandeGauche), m_operandeDroit(operandeDroit),
+m_resolue(nullptr) {
 }
 
 int NoeudOperateurBinaire::executer() {
-    int og, od, valeur;
-    if (m_operandeGauche != nullptr) og = m_operandeGauche->executer(); // On évalue l'opérande gauche
-    if (m_operandeDroit != nullptr) od = m_operandeDroit->executer(); // On évalue l'opérande droit
-    // Et on combine les deux opérandes en fonctions de l'opérateur
-    if (this->m_operateur == "+") valeur = (og + od);
-    else if (this->m_operateur == "-") valeur = (og - od);
-    else if (this->m_operateur == "*") valeur = (og * od);
-    else if (this->m_operateur == "==") valeur = (og == od);
-    else if (this->m_operateur == "!=") valeur = (og != od);
-    else if (this->m_operateur == "<") valeur = (og < od);
-    else if (this->m_operateur == ">") valeur = (og > od);
-    else if (this->m_operateur == "<=") valeur = (og <= od);
-    else if (this->m_operateur == ">=") valeur = (og >= od);
-    else if (this->m_operateur == "et") valeur = (og && od);
-    else if (this->m_operateur == "ou") valeur = (og || od);
-    else if (this->m_operateur == "non") valeur = (!og);
-    else if (this->m_operateur == "/") {
-        if (od == 0) throw DivParZeroException();
-        valeur = og / od;
-    }
-    return valeur; // On retourne la valeur calculée
+    int og = m_operandeGauche->executer(); // On évalue l'opérande gauche
+    int od = m_operandeDroit->executer(); // On évalue l'opérande droit
+    // Et on combine les deux opérandes en fonctions du code de l'opérateur
+    return calculer(m_operateur.getCode(), og, od); // On retourne la valeur calculée
+}
+
+Noeud* NoeudOperateurBinaire::resoudre(Cadre & cadre, Arene & arene) {
+    if (m_resolue != nullptr) return m_resolue; // déjà résolue par une autre occurrence
+    m_operandeGauche = m_operandeGauche->resoudre(cadre, arene);
+    m_operandeDroit = m_operandeDroit->resoudre(cadre, arene);
+    m_resolue = specialiserOperation(this, m_operandeGauche, m_operandeDroit, arene);
+    ((NoeudOperateurBinaire *) m_resolue)->m_resolue = m_resolue; // une forme spécialisée est déjà résolue
+    return m_resolue;
+}
+
+Noeud* NoeudOperateurBinaire::optimiser(Optimiseur & optimiseur) {
+    Noeud* gauche = optimiseur.optimiserFils(m_operandeGauche);
+    Noeud* droit = optimiseur.optimiserFils(m_operandeDroit);
+    Noeud* simplifie = optimiseur.simplifierOperation(m_operateur.getCode(), gauche, droit);
+    if (simplifie != nullptr) return simplifie;
+    if (gauche == m_operandeGauche && droit == m_operandeDroit && !optimiseur.diviseurNonNul(m_operateur.getCode(), droit))
+        return this;
+    return optimiseur.operation(m_operateur, gauche, droit); // nouvelle opération, spécialisée pour ses nouveaux opérandes
+}
+
+void NoeudOperateurBinaire::parcourirFils(const function<void(Noeud*)> & action) const {
+    action(m_operandeGauche);
+    action(m_operandeDroit);
+}
+
+uint32_t NoeudOperateurBinaire::aplatir(ArbrePlat & plat) {
+    uint32_t gauche = m_operandeGauche->aplatir(plat);
+    return plat.ajouter(P_OPERATEUR, gauche, m_operandeDroit->aplatir(plat), m_operateur.getCode());
 }
 
 void NoeudOperateurBinaire::traduitEnCPP(std::ostream& cout, unsigned int indentation) const {
-    cout << setw(4 * indentation) << "";
+    // Le langage n'a pas de priorités : chaque opération est parenthésée
+    cout << setw(4 * indentation) << "" << "(";
+    m_operandeGauche->traduitEnCPP(cout, 0);
+    cout << " " << operateurCPP(m_operateur.getCode()) << " ";
+    m_operandeDroit->traduitEnCPP(cout, 0);
+    cout << ")";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// NoeudOperateurLogique
+////////////////////////////////////////////////////////////////////////////////
+
+NoeudOperateurLogique::NoeudOperateurLogique(Symbole operateur, Noeud* operandeGauche, Noeud* operandeDroit)
+: Noeud(Genre::LOGIQUE), m_operateur(operateur), m_operandeGauche(operandeGauche), m_operandeDroit(operandeDroit) {
+}
+
+int NoeudOperateurLogique::executer() {
+    if (m_operateur.getCode() == S_ET)
+        return m_operandeGauche->executer() && m_operandeDroit->executer();
+    return m_operandeGauche->executer() || m_operandeDroit->executer();
+}
+
+Noeud* NoeudOperateurLogique::resoudre(Cadre & cadre, Arene & arene) {
+    m_operandeGauche = m_operandeGauche->resoudre(cadre, arene);
+    m_operandeDroit = m_operandeDroit->resoudre(cadre, arene);
+    return this;
+}
+
+Noeud* NoeudOperateurLogique::optimiser(Optimiseur & optimiseur) {
+    Noeud* gauche = optimiseur.optimiserFils(m_operandeGauche);
+    Noeud* droit = optimiseur.optimiserFils(m_operandeDroit);
+    Noeud* simplifie = optimiseur.simplifierLogique(m_operateur.getCode(), gauche, droit);
+    if (simplifie != nullptr) return simplifie;
+    if (gauche == m_operandeGauche && droit == m_operandeDroit) return this;
+    return optimiseur.getArene().creer<NoeudOperateurLogique>(m_operateur, gauche, droit);
+}
+
+void NoeudOperateurLogique::parcourirFils(const function<void(Noeud*)> & action) const {
+    action(m_operandeGauche);
+    action(m_operandeDroit);
+}
+
+uint32_t NoeudOperateurLogique::aplatir(ArbrePlat & plat) {
+    uint32_t gauche = m_operandeGauche->aplatir(plat);
+    return plat.ajouter(P_LOGIQUE, gauche, m_operandeDroit->aplatir(plat), m_operateur.getCode());
+}
+
+void NoeudOperateurLogique::traduitEnCPP(std::ostream& cout, unsigned int indentation) const {
+    cout << setw(4 * indentation) << "" << "(";
     m_operandeGauche->traduitEnCPP(cout, 0);
-    cout << " " << m_operateur.getChaine() << " ";
+    cout << " " << operateurCPP(m_operateur.getCode()) << " ";
     m_operandeDroit->traduitEnCPP(cout, 0);
+    cout << ")";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// NoeudOperateurUnaire
+////////////////////////////////////////////////////////////////////////////////
+
+NoeudOperateurUnaire::NoeudOperateurUnaire(Symbole operateur, Noeud* operande)
+: Noeud(Genre::UNAIRE), m_operateur(operateur), m_operande(operande) {
+}
+
+int NoeudOperateurUnaire::executer() {
+    return calculerUnaire(m_operateur.getCode(), m_operande->executer());
+}
+
+Noeud* NoeudOperateurUnaire::resoudre(Cadre & cadre, Arene & arene) {
+    m_operande = m_operande->resoudre(cadre, arene);
+    return this;
+}
+
+Noeud* NoeudOperateurUnaire::optimiser(Optimiseur & optimiseur) {
+    Noeud* operande = optimiseur.optimiserFils(m_operande);
+    Noeud* simplifie = optimiseur.simplifierUnaire(m_operateur.getCode(), operande);
+    if (simplifie != nullptr) return simplifie;
+    if (operande == m_operande) return this;
+    return optimiseur.getArene().creer<NoeudOperateurUnaire>(m_operateur, operande);
+}
+
+void NoeudOperateurUnaire::parcourirFils(const function<void(Noeud*)> & action) const {
+    action(m_operande);
+}
+
+uint32_t NoeudOperateurUnaire::aplatir(ArbrePlat & plat) {
+    return plat.ajouter(P_UNAIRE, m_operande->aplatir(plat), ArbrePlat::AUCUN, m_operateur.getCode());
+}
+
+void NoeudOperateurUnaire::traduitEnCPP(std::ostream& cout, unsigned int indentation) const {
+    cout << setw(4 * indentation) << "" << "(" << operateurCPP(m_operateur.getCode());
+    m_operande->traduitEnCPP(cout, 0);
+    cout << ")";
 }
 
 
@@ -107,7 +288,7 @@ void NoeudOperateurBinaire::traduitEnCPP(std::ostream& cout, unsigned int indent
 ////////////////////////////////////////////////////////////////////////////////
 
 NoeudInstSi::NoeudInstSi(Noeud* condition, Noeud* sequence)
-: m_condition(condition), m_sequence(sequence) {
+: Noeud(Genre::SI), m_condition(condition), m_sequence(sequence) {
 }
 
 int NoeudInstSi::executer() {
@@ -115,12 +296,55 @@ int NoeudInstSi::executer() {
     return 0; // La valeur renvoyée ne représente rien !
 }
 
+Noeud* NoeudInstSi::resoudre(Cadre & cadre, Arene & arene) {
+    m_condition = m_condition->resoudre(cadre, arene);
+    m_sequence = m_sequence->resoudre(cadre, arene);
+    return this;
+}
+
+Noeud* NoeudInstSi::optimiser(Optimiseur & optimiseur) {
+    m_condition = optimiseur.optimiserExpression(m_condition);
+    Optimiseur::Etat etat = optimiseur.getEtat();
+    optimiseur.supposer(m_condition);
+    m_sequence = optimiseur.optimiserFils(m_sequence);
+    int valeur;
+    if (!Optimiseur::estConstante(m_condition, valeur)) {
+        optimiseur.restreindre(etat); // la séquence n'est pas toujours exécutée
+        optimiseur.setEtat(etat);
+        return this;
+    }
+    optimiseur.compter(Optimiseur::BRANCHES_SUPPRIMEES);
+    if (valeur) return m_sequence;
+    optimiseur.setEtat(etat);
+    return optimiseur.sequenceVide();
+}
+
+void NoeudInstSi::parcourirFils(const function<void(Noeud*)> & action) const {
+    action(m_condition);
+    action(m_sequence);
+}
+
+uint32_t NoeudInstSi::aplatir(ArbrePlat & plat) {
+    vector<uint32_t> fils;
+    fils.push_back(m_condition->aplatir(plat));
+    fils.push_back(m_sequence->aplatir(plat));
+    return plat.ajouterListe(P_SIRICHE, fils);
+}
+
+void NoeudInstSi::traduitEnCPP(std::ostream& cout, unsigned int indentation) const {
+    cout << setw(4 * indentation) << "" << "if (";
+    m_condition->traduitEnCPP(cout, 0);
+    cout << ") {" << endl;
+    m_sequence->traduitEnCPP(cout, indentation + 1);
+    cout << setw(4 * indentation) << "" << "}";
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // NoeudTantQue
 ////////////////////////////////////////////////////////////////////////////////
 
 NoeudInstTantQue::NoeudInstTantQue(Noeud* condition, Noeud* sequence)
-: m_condition(condition), m_sequence(sequence) {
+: Noeud(Genre::TANTQUE), m_condition(condition), m_sequence(sequence) {
 }
 
 int NoeudInstTantQue::executer() {
@@ -128,12 +352,46 @@ int NoeudInstTantQue::executer() {
     return 0; // La valeur renvoyée ne représente rien !
 }
 
+Noeud* NoeudInstTantQue::resoudre(Cadre & cadre, Arene & arene) {
+    m_condition = m_condition->resoudre(cadre, arene);
+    m_sequence = m_sequence->resoudre(cadre, arene);
+    return specialiserBoucle(this, arene); // comparaison faite dans la boucle si la condition s'y prête
+}
+
+Noeud* NoeudInstTantQue::optimiser(Optimiseur & optimiseur) {
+    optimiseur.entrerBoucle(this);
+    Optimiseur::Etat etat = optimiseur.getEtat();
+    m_condition = optimiseur.optimiserExpression(m_condition);
+    optimiseur.supposer(m_condition); // au début de chaque tour
+    m_sequence = optimiseur.optimiserFils(m_sequence);
+    optimiseur.setEtat(etat); // la séquence peut n'être jamais exécutée
+    Noeud* specialisee = specialiserBoucle(this, optimiseur.getArene()); // pour la nouvelle condition
+    Noeud* calculee = optimiseur.calculerBoucle(specialisee, nullptr, m_condition, m_sequence, nullptr);
+    Noeud* boucle = optimiseur.sortirBoucle(calculee != nullptr ? calculee : specialisee);
+    int valeur;
+    if (Optimiseur::estConstante(m_condition, valeur) && valeur == 0) { // la séquence n'est jamais exécutée
+        optimiseur.compter(Optimiseur::BRANCHES_SUPPRIMEES);
+        return optimiseur.sequenceVide();
+    }
+    return boucle;
+}
+
+void NoeudInstTantQue::parcourirFils(const function<void(Noeud*)> & action) const {
+    action(m_condition);
+    action(m_sequence);
+}
+
+uint32_t NoeudInstTantQue::aplatir(ArbrePlat & plat) {
+    uint32_t condition = m_condition->aplatir(plat);
+    return plat.ajouter(P_TANTQUE, condition, m_sequence->aplatir(plat));
+}
+
 void NoeudInstTantQue::traduitEnCPP(std::ostream& cout, unsigned int indentation) const {
-    cout << setw(4 * indentation) << "while(";
+    cout << setw(4 * indentation) << "" << "while (";
     m_condition->traduitEnCPP(cout, 0);
-    cout << "){" << endl;
+    cout << ") {" << endl;
     m_sequence->traduitEnCPP(cout, indentation + 1);
-    cout << setw(4 * indentation) << "}";
+    cout << setw(4 * indentation) << "" << "}";
 }
 
 
@@ -142,7 +400,7 @@ void NoeudInstTantQue::traduitEnCPP(std::ostream& cout, unsigned int indentation
 ////////////////////////////////////////////////////////////////////////////////
 
 NoeudInstRepeter::NoeudInstRepeter(Noeud* sequence, Noeud* condition)
-: m_condition(condition), m_sequence(sequence) {
+: Noeud(Genre::REPETER), m_condition(condition), m_sequence(sequence) {
 }
 
 int NoeudInstRepeter::executer() {
@@ -152,10 +410,33 @@ int NoeudInstRepeter::executer() {
     return 0; // La valeur renvoyée ne représente rien !
 }
 
+Noeud* NoeudInstRepeter::resoudre(Cadre & cadre, Arene & arene) {
+    m_sequence = m_sequence->resoudre(cadre, arene);
+    m_condition = m_condition->resoudre(cadre, arene);
+    return specialiserBoucle(this, arene);
+}
+
+Noeud* NoeudInstRepeter::optimiser(Optimiseur & optimiseur) {
+    optimiseur.entrerBoucle(this);
+    m_sequence = optimiseur.optimiserFils(m_sequence); // exécutée au moins une fois : ce qu'elle définit le reste
+    m_condition = optimiseur.optimiserExpression(m_condition);
+    return optimiseur.sortirBoucle(specialiserBoucle(this, optimiseur.getArene())); // pour la nouvelle condition
+}
+
+void NoeudInstRepeter::parcourirFils(const function<void(Noeud*)> & action) const {
+    action(m_sequence);
+    action(m_condition);
+}
+
+uint32_t NoeudInstRepeter::aplatir(ArbrePlat & plat) {
+    uint32_t sequence = m_sequence->aplatir(plat);
+    return plat.ajouter(P_REPETER, sequence, m_condition->aplatir(plat));
+}
+
 void NoeudInstRepeter::traduitEnCPP(std::ostream& cout, unsigned int indentation) const {
-    cout << setw(4 * indentation) << "" << "do " << endl;
+    cout << setw(4 * indentation) << "" << "do {" << endl;
     m_sequence->traduitEnCPP(cout, indentation + 1);
-    cout << setw(4 * indentation) << "" << "while (";
+    cout << setw(4 * indentation) << "" << "} while (!"; // repeter ... jusqua (condition) : on boucle tant qu'elle est fausse
     m_condition->traduitEnCPP(cout, 0);
     cout << ");";
 }
@@ -165,7 +446,7 @@ void NoeudInstRepeter::traduitEnCPP(std::ostream& cout, unsigned int indentation
 ////////////////////////////////////////////////////////////////////////////////
 
 NoeudInstPour::NoeudInstPour(Noeud* affecter, Noeud* condition, Noeud* action, Noeud* sequence)
-: m_affecter(affecter), m_condition(condition), m_action(action), m_sequence(sequence) {
+: Noeud(Genre::POUR), m_affecter(affecter), m_condition(condition), m_action(action), m_sequence(sequence) {
 }
 
 int NoeudInstPour::executer() {
@@ -189,25 +470,235 @@ int NoeudInstPour::executer() {
 
 }
 
+Noeud* NoeudInstPour::resoudre(Cadre & cadre, Arene & arene) {
+    if (m_affecter != nullptr) m_affecter = m_affecter->resoudre(cadre, arene);
+    m_condition = m_condition->resoudre(cadre, arene);
+    if (m_action != nullptr) m_action = m_action->resoudre(cadre, arene);
+    m_sequence = m_sequence->resoudre(cadre, arene);
+    return specialiserBoucle(this, arene);
+}
+
+Noeud* NoeudInstPour::optimiser(Optimiseur & optimiseur) {
+    if (m_affecter != nullptr) m_affecter = optimiseur.optimiserFils(m_affecter);
+    optimiseur.entrerBoucle(this);
+    Optimiseur::Etat etat = optimiseur.getEtat();
+    m_condition = optimiseur.optimiserExpression(m_condition);
+    optimiseur.supposer(m_condition); // au début de chaque tour
+    optimiseur.bornerCompteur(m_sequence, m_action);
+    m_sequence = optimiseur.optimiserFils(m_sequence);
+    if (m_action != nullptr) m_action = optimiseur.optimiserFils(m_action);
+    optimiseur.setEtat(etat); // seule l'affectation est toujours exécutée
+    Noeud* specialisee = specialiserBoucle(this, optimiseur.getArene()); // pour la nouvelle condition
+    Noeud* calculee = optimiseur.calculerBoucle(specialisee, m_affecter, m_condition, m_sequence, m_action);
+    Noeud* boucle = optimiseur.sortirBoucle(calculee != nullptr ? calculee : specialisee);
+    int valeur;
+    if (Optimiseur::estConstante(m_condition, valeur) && valeur == 0) { // seule l'affectation est exécutée
+        optimiseur.compter(Optimiseur::BRANCHES_SUPPRIMEES);
+        return m_affecter != nullptr ? m_affecter : optimiseur.sequenceVide();
+    }
+    return boucle;
+}
+
+void NoeudInstPour::parcourirFils(const function<void(Noeud*)> & action) const {
+    if (m_affecter != nullptr) action(m_affecter);
+    action(m_condition);
+    action(m_sequence);
+    if (m_action != nullptr) action(m_action);
+}
+
+uint32_t NoeudInstPour::aplatir(ArbrePlat & plat) {
+    vector<uint32_t> fils(4, ArbrePlat::AUCUN); // affecter, condition, action, séquence
+    if (m_affecter != nullptr) fils[0] = m_affecter->aplatir(plat);
+    fils[1] = m_condition->aplatir(plat);
+    if (m_action != nullptr) fils[2] = m_action->aplatir(plat);
+    fils[3] = m_sequence->aplatir(plat);
+    return plat.ajouterListe(P_POUR, fils);
+}
+
 void NoeudInstPour::traduitEnCPP(std::ostream& cout, unsigned int indentation) const {
     cout << setw(4 * indentation) << "" << "for (";
-    m_affecter->traduitEnCPP(cout, 0);
+    if (m_affecter != nullptr) m_affecter->traduitEnCPP(cout, 0);
     cout << "; ";
     m_condition->traduitEnCPP(cout, 0);
     cout << "; ";
-    m_action->traduitEnCPP(cout, 0);
+    if (m_action != nullptr) m_action->traduitEnCPP(cout, 0);
     cout << ") {" << endl;
     m_sequence->traduitEnCPP(cout, indentation + 1);
     cout << setw(4 * indentation) << "" << "}";
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// NoeudBoucleCalculee
+////////////////////////////////////////////////////////////////////////////////
+
+// En dessous de ce nombre d'itérations, exécuter la boucle coûte moins que la calculer
+static const int64_t ITERATIONS_MIN = 16;
+
+static vector<uint32_t> produit(const vector<uint32_t> & a, const vector<uint32_t> & b, size_t taille) {
+    // Produit de deux matrices carrées taille x taille (rangées ligne par ligne), modulo 2^32
+    vector<uint32_t> resultat(taille * taille, 0);
+    for (size_t i = 0; i < taille; i++)
+        for (size_t k = 0; k < taille; k++)
+            if (a[i * taille + k] != 0)
+                for (size_t j = 0; j < taille; j++) resultat[i * taille + j] += a[i * taille + k] * b[k * taille + j];
+    return resultat;
+}
+
+NoeudBoucleCalculee::NoeudBoucleCalculee(Noeud* boucle, Noeud* affecter, Noeud* condition, Noeud* sequence, Noeud* action,
+        Cadre & cadre, const Recurrence & recurrence)
+: Noeud(Genre::BOUCLE_CALCULEE), m_boucle(boucle), m_affecter(affecter), m_condition(condition), m_sequence(sequence), m_action(action), m_cadre(cadre),
+m_recurrence(recurrence), m_rangs(), m_invariantes(), m_valeursInvariantes(), m_matrice() {
+    for (unsigned int rang = 0; rang < m_recurrence.variables.size(); rang++) {
+        unsigned int numeroCase = m_recurrence.variables[rang];
+        if (numeroCase >= m_rangs.size()) m_rangs.resize(numeroCase + 1, -1);
+        m_rangs[numeroCase] = rang;
+    }
+    for (unsigned int numeroCase : m_recurrence.entree)
+        if (numeroCase >= m_rangs.size() || m_rangs[numeroCase] < 0) m_invariantes.push_back(numeroCase);
+    m_valeursInvariantes.resize(m_invariantes.size());
+}
+
+int NoeudBoucleCalculee::executer() {
+    if (m_affecter != nullptr) m_affecter->executer();
+    if (calculer()) return 0;
+    while (m_condition->executer()) {
+        m_sequence->executer();
+        if (m_action != nullptr) m_action->executer();
+    }
+    return 0; // La valeur renvoyée ne représente rien !
+}
+
+bool NoeudBoucleCalculee::calculer() {
+    // Une variable lue indéfinie : la boucle lèvera l'exception au bon moment
+    for (unsigned int numeroCase : m_recurrence.entree)
+        if (!m_cadre.estDefini(numeroCase)) return false;
+    // La matrice ne dépend que des variables lues qui ne sont pas affectées dans la boucle
+    bool inchangees = !m_matrice.empty();
+    for (size_t i = 0; i < m_invariantes.size() && inchangees; i++)
+        inchangees = m_cadre.getValeur(m_invariantes[i]) == m_valeursInvariantes[i];
+    if (!inchangees) construireMatrice();
+    // Le compteur doit avancer d'un pas fixe : compteur = compteur + pas
+    size_t nbVariables = m_recurrence.variables.size(), taille = nbVariables + 1;
+    size_t ligne = m_rangs[m_recurrence.compteur] * taille;
+    for (size_t rang = 0; rang < nbVariables; rang++)
+        if (m_matrice[ligne + rang] != (ligne == rang * taille ? 1u : 0u)) return false;
+    int64_t pas = (int32_t) m_matrice[ligne + nbVariables];
+    int64_t debut = m_cadre.getValeur(m_recurrence.compteur), borne = m_recurrence.borne->executer(), iterations;
+    switch (m_recurrence.comparaison) {
+        case S_INFERIEUR:
+            if (debut >= borne) iterations = 0;
+            else if (pas <= 0) return false;
+            else iterations = (borne - debut + pas - 1) / pas;
+            break;
+        case S_INFERIEUREGAL:
+            if (debut > borne) iterations = 0;
+            else if (pas <= 0) return false;
+            else iterations = (borne - debut) / pas + 1;
+            break;
+        case S_SUPERIEUR:
+            if (debut <= borne) iterations = 0;
+            else if (pas >= 0) return false;
+            else iterations = (debut - borne - pas - 1) / -pas;
+            break;
+        default: // S_SUPERIEUREGAL
+            if (debut < borne) iterations = 0;
+            else if (pas >= 0) return false;
+            else iterations = (debut - borne) / -pas + 1;
+            break;
+    }
+    if (iterations == 0) return true; // la condition est fausse d'emblée (et son évaluation ne change rien)
+    int64_t fin = debut + iterations * pas; // si le compteur débordait, la condition pourrait rester vraie
+    if (fin < INT32_MIN || fin > INT32_MAX || iterations < ITERATIONS_MIN) return false;
+    // Puissance de la matrice de l'itération, appliquée aux valeurs d'entrée
+    vector<uint32_t> matrice = m_matrice, valeurs(taille, 1);
+    for (size_t rang = 0; rang < nbVariables; rang++)
+        valeurs[rang] = m_cadre.getValeurs()[m_recurrence.variables[rang]]; // coefficient nul si elle n'est pas définie
+    for (uint64_t reste = iterations; reste != 0; reste >>= 1) {
+        if (reste & 1) {
+            vector<uint32_t> suivantes(taille, 0);
+            for (size_t i = 0; i < taille; i++)
+                for (size_t j = 0; j < taille; j++) suivantes[i] += matrice[i * taille + j] * valeurs[j];
+            valeurs = move(suivantes);
+        }
+        if (reste > 1) matrice = produit(matrice, matrice, taille);
+    }
+    for (size_t rang = 0; rang < nbVariables; rang++) m_cadre.setValeur(m_recurrence.variables[rang], (int) valeurs[rang]);
+    return true;
+}
+
+void NoeudBoucleCalculee::construireMatrice() {
+    // Effet d'une itération : chaque variable, forme affine des variables à l'entrée de l'itération
+    size_t nbVariables = m_recurrence.variables.size(), taille = nbVariables + 1;
+    vector<vector<uint32_t> > etat(nbVariables, vector<uint32_t>(taille, 0));
+    for (size_t rang = 0; rang < nbVariables; rang++) etat[rang][rang] = 1;
+    for (NoeudAffectation* affectation : m_recurrence.iteration) {
+        vector<uint32_t> valeur;
+        forme(affectation->getExpression(), etat, valeur);
+        etat[m_rangs[((NoeudVariable *) affectation->getVariable())->getCase()]] = move(valeur);
+    }
+    m_matrice.assign(taille * taille, 0);
+    for (size_t rang = 0; rang < nbVariables; rang++)
+        for (size_t j = 0; j < taille; j++) m_matrice[rang * taille + j] = etat[rang][j];
+    m_matrice[nbVariables * taille + nbVariables] = 1; // dernière ligne : la constante 1
+    for (size_t i = 0; i < m_invariantes.size(); i++) m_valeursInvariantes[i] = m_cadre.getValeur(m_invariantes[i]);
+}
+
+void NoeudBoucleCalculee::forme(Noeud* expression, const vector<vector<uint32_t> > & etat, vector<uint32_t> & resultat) const {
+    // L'optimiseur n'a gardé que des entiers, des variables, des moins unaires, des + et des -, et des * dont
+    //  un opérande ne lit aucune variable de la boucle (sa forme est une constante)
+    size_t nbVariables = etat.size();
+    if (expression->getGenre() == Genre::ENTIER) {
+        resultat.assign(nbVariables + 1, 0);
+        resultat[nbVariables] = ((NoeudEntier *) expression)->getValeur();
+    } else if (estVariable(expression)) {
+        unsigned int numeroCase = ((NoeudVariable *) expression)->getCase();
+        if (numeroCase < m_rangs.size() && m_rangs[numeroCase] >= 0) resultat = etat[m_rangs[numeroCase]];
+        else { // pas affectée dans la boucle : sa valeur, définie puisqu'elle est lue à l'entrée
+            resultat.assign(nbVariables + 1, 0);
+            resultat[nbVariables] = m_cadre.getValeur(numeroCase);
+        }
+    } else if (expression->getGenre() == Genre::UNAIRE) {
+        forme(((NoeudOperateurUnaire *) expression)->getOperande(), etat, resultat);
+        for (uint32_t & coefficient : resultat) coefficient = 0u - coefficient;
+    } else {
+        NoeudOperateurBinaire * operation = (NoeudOperateurBinaire *) expression;
+        vector<uint32_t> droit;
+        forme(operation->getOperandeGauche(), etat, resultat);
+        forme(operation->getOperandeDroit(), etat, droit);
+        switch (operation->getOperateur().getCode()) {
+            case S_PLUS:
+                for (size_t j = 0; j <= nbVariables; j++) resultat[j] += droit[j];
+                break;
+            case S_MOINS:
+                for (size_t j = 0; j <= nbVariables; j++) resultat[j] -= droit[j];
+                break;
+            default: { // S_MULTIPLIE
+                bool gaucheConstante = true;
+                for (size_t j = 0; j < nbVariables; j++) gaucheConstante = gaucheConstante && resultat[j] == 0;
+                uint32_t facteur = gaucheConstante ? resultat[nbVariables] : droit[nbVariables];
+                if (gaucheConstante) resultat = droit;
+                for (uint32_t & coefficient : resultat) coefficient *= facteur;
+                break;
+            }
+        }
+    }
+}
+
+void NoeudBoucleCalculee::parcourirFils(const function<void(Noeud*)> & action) const {
+    action(m_boucle);
+}
+
+void NoeudBoucleCalculee::traduitEnCPP(std::ostream& cout, unsigned int indentation) const {
+    m_boucle->traduitEnCPP(cout, indentation);
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // NoeudEcrire
 ////////////////////////////////////////////////////////////////////////////////
 
 NoeudInstEcrire::NoeudInstEcrire()
-: m_vecteurEcrire() {
+: Noeud(Genre::ECRIRE), m_vecteurEcrire() {
 
 }
 
@@ -217,9 +708,8 @@ void NoeudInstEcrire::ajoute(Noeud* parametre) {
 
 int NoeudInstEcrire::executer() {
     for (auto param : m_vecteurEcrire) {
-        if ((typeid (*param) == typeid (SymboleValue)) && *((SymboleValue*) param) == "<CHAINE>") {
-            string chaine = ((SymboleValue*) param)->getChaine();
-            cout << chaine.substr(1, chaine.size() - 2);
+        if (param->getGenre() == Genre::CHAINE) {
+            cout << ((NoeudChaine*) param)->getTexte();
         } else {
             cout << param->executer();
         }
@@ -227,15 +717,31 @@ int NoeudInstEcrire::executer() {
     return 0;
 }
 
+Noeud* NoeudInstEcrire::resoudre(Cadre & cadre, Arene & arene) {
+    for (auto & param : m_vecteurEcrire) param = param->resoudre(cadre, arene);
+    return this;
+}
+
+Noeud* NoeudInstEcrire::optimiser(Optimiseur & optimiseur) {
+    for (auto & param : m_vecteurEcrire) param = optimiseur.optimiserExpression(param);
+    return this;
+}
+
+void NoeudInstEcrire::parcourirFils(const function<void(Noeud*)> & action) const {
+    for (auto param : m_vecteurEcrire) action(param);
+}
+
+uint32_t NoeudInstEcrire::aplatir(ArbrePlat & plat) {
+    vector<uint32_t> fils;
+    for (auto param : m_vecteurEcrire) fils.push_back(param->aplatir(plat));
+    return plat.ajouterListe(P_ECRIRE, fils);
+}
+
 void NoeudInstEcrire::traduitEnCPP(std::ostream& cout, unsigned int indentation) const {
     cout << setw(4 * indentation) << "" << "cout";
     for (auto p : m_vecteurEcrire) {
-        if ((typeid (*p) == typeid (SymboleValue) && *((SymboleValue*) p) == "<CHAINE>")) {
-            cout << " << " << ((SymboleValue*) p)->getChaine();
-        } else {
-            cout << " << ";
-            p->traduitEnCPP(cout, 0);
-        }
+        cout << " << ";
+        p->traduitEnCPP(cout, 0);
     }
 }
 
@@ -246,7 +752,7 @@ void NoeudInstEcrire::traduitEnCPP(std::ostream& cout, unsigned int indentation)
 // NoeudSiRiche
 ////////////////////////////////////////////////////////////////////////////////
 
-NoeudInstSiRiche::NoeudInstSiRiche() : m_vecteurConditonInstruction() {
+NoeudInstSiRiche::NoeudInstSiRiche() : Noeud(Genre::SI_RICHE), m_vecteurConditonInstruction() {
 
 }
 
@@ -269,26 +775,82 @@ int NoeudInstSiRiche::executer() {
     return 0;
 }
 
+Noeud* NoeudInstSiRiche::resoudre(Cadre & cadre, Arene & arene) {
+    for (auto & fils : m_vecteurConditonInstruction) fils = fils->resoudre(cadre, arene);
+    return specialiserSiRiche(this, arene); // table de branches si les conditions s'y prêtent
+}
+
+Noeud* NoeudInstSiRiche::optimiser(Optimiseur & optimiseur) {
+    // Une condition toujours fausse : sa branche disparaît ; toujours vraie : sa séquence devient le sinon
+    //  et les branches suivantes disparaissent. Après le si, seules les variables définies par toutes
+    //  les branches (s'il y a un sinon) sont sûrement définies.
+    vector<Noeud*> fils;
+    size_t nb = m_vecteurConditonInstruction.size(), i = 0;
+    Noeud* sinon = (nb % 2) ? m_vecteurConditonInstruction[nb - 1] : nullptr;
+    Optimiseur::Etat avant = optimiseur.getEtat(), communes;
+    for (; i + 2 <= nb; i += 2) {
+        Noeud* condition = optimiseur.optimiserExpression(m_vecteurConditonInstruction[i]);
+        int valeur;
+        if (!Optimiseur::estConstante(condition, valeur)) {
+            fils.push_back(condition);
+            optimiseur.supposer(condition);
+            fils.push_back(optimiseur.optimiserFils(m_vecteurConditonInstruction[i + 1]));
+            if (fils.size() == 2) communes = optimiseur.getEtat();
+            else optimiseur.restreindre(communes);
+            optimiseur.setEtat(avant);
+        } else if (valeur == 0) {
+            optimiseur.compter(Optimiseur::BRANCHES_SUPPRIMEES);
+        } else {
+            optimiseur.compter(Optimiseur::BRANCHES_SUPPRIMEES);
+            sinon = m_vecteurConditonInstruction[i + 1];
+            break;
+        }
+    }
+    if (sinon != nullptr) sinon = optimiseur.optimiserFils(sinon);
+    if (fils.empty()) return sinon != nullptr ? sinon : optimiseur.sequenceVide(); // définies : celles du sinon
+    if (sinon != nullptr) {
+        optimiseur.restreindre(communes);
+        optimiseur.setEtat(communes);
+        fils.push_back(sinon);
+    } else { // aucune branche n'est peut-être exécutée
+        optimiseur.setEtat(avant);
+        optimiseur.restreindre(communes);
+        optimiseur.setEtat(communes);
+    }
+    m_vecteurConditonInstruction = move(fils);
+    return specialiserSiRiche(this, optimiseur.getArene()); // pour les nouvelles conditions
+}
+
+void NoeudInstSiRiche::parcourirFils(const function<void(Noeud*)> & action) const {
+    for (auto f : m_vecteurConditonInstruction) action(f);
+}
+
+uint32_t NoeudInstSiRiche::aplatir(ArbrePlat & plat) {
+    vector<uint32_t> fils;
+    for (auto f : m_vecteurConditonInstruction) fils.push_back(f->aplatir(plat));
+    return plat.ajouterListe(P_SIRICHE, fils);
+}
+
 void NoeudInstSiRiche::traduitEnCPP(std::ostream& cout, unsigned int indentation) const {
-    int i = 0;
-    cout << setw(4 * indentation) << "" << "if(";
+    unsigned int i = 0;
+    cout << setw(4 * indentation) << "" << "if (";
     m_vecteurConditonInstruction[i]->traduitEnCPP(cout, 0);
     i++;
-    cout << setw(4 * indentation) << "){"<< endl;
+    cout << ") {" << endl;
     m_vecteurConditonInstruction[i]->traduitEnCPP(cout, indentation + 1);
-    cout << setw(4 * indentation) << "" << "}" << endl;
+    cout << setw(4 * indentation) << "" << "}";
     i++;
-    while (i <= m_vecteurConditonInstruction.size()-2) {
-        cout << setw(4 * indentation) << "" << "else if (";
+    while (i + 2 <= m_vecteurConditonInstruction.size()) {
+        cout << " else if (";
         m_vecteurConditonInstruction[i]->traduitEnCPP(cout, 0);
         i++;
-        cout << setw(4 * indentation) << "){"<<endl;
+        cout << ") {" << endl;
         m_vecteurConditonInstruction[i]->traduitEnCPP(cout, indentation + 1);
-        cout << setw(4 * indentation) << "" << "}" << endl;
+        cout << setw(4 * indentation) << "" << "}";
         i++;
     }
     if (m_vecteurConditonInstruction.size() % 2) {
-        cout << setw(4 * indentation) << "" << "else {" << endl;
+        cout << " else {" << endl;
         m_vecteurConditonInstruction[m_vecteurConditonInstruction.size() - 1]->traduitEnCPP(cout, indentation + 1);
         cout << setw(4 * indentation) << "" << "}";
     }
@@ -298,7 +860,7 @@ void NoeudInstSiRiche::traduitEnCPP(std::ostream& cout, unsigned int indentation
 // NoeudLire
 ////////////////////////////////////////////////////////////////////////////////
 
-NoeudInstLire::NoeudInstLire() {
+NoeudInstLire::NoeudInstLire() : Noeud(Genre::LIRE), m_varLire() {
 }
 
 void NoeudInstLire::ajoute(Noeud* variable) {
@@ -309,15 +871,95 @@ int NoeudInstLire::executer() {
     for (auto var : m_varLire) {
         int val;
         cin >> val;
-        ((SymboleValue*) var)->setValeur(val);
+        var->affecter(val);
     }
     return 0;
 }
 
+Noeud* NoeudInstLire::resoudre(Cadre & cadre, Arene & arene) {
+    for (auto & var : m_varLire) var = var->resoudre(cadre, arene);
+    return this;
+}
+
+Noeud* NoeudInstLire::optimiser(Optimiseur & optimiseur) {
+    for (auto var : m_varLire) optimiseur.definir(var);
+    return this;
+}
+
+void NoeudInstLire::parcourirFils(const function<void(Noeud*)> & action) const {
+    for (auto var : m_varLire) action(var);
+}
+
+uint32_t NoeudInstLire::aplatir(ArbrePlat & plat) {
+    vector<uint32_t> fils;
+    for (auto var : m_varLire) fils.push_back(var->aplatir(plat));
+    return plat.ajouterListe(P_LIRE, fils);
+}
+
 void NoeudInstLire::traduitEnCPP(std::ostream& cout, unsigned int indentation) const {
     cout << setw(4 * indentation) << "" << "cin";
     for (auto p : m_varLire) {
         cout << " >> ";
         p->traduitEnCPP(cout, 0);
     }
-}
\ No newline at end of file
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// NoeudVariable
+////////////////////////////////////////////////////////////////////////////////
+
+NoeudVariable::NoeudVariable(Cadre & cadre, unsigned int numeroCase)
+: Noeud(Genre::VARIABLE), m_cadre(cadre), m_case(numeroCase) {
+}
+
+void NoeudVariable::traduitEnCPP(std::ostream& cout, unsigned int indentation) const {
+    cout << m_cadre.getNom(m_case);
+}
+
+Noeud* NoeudVariable::optimiser(Optimiseur & optimiseur) {
+    if (m_specialise) return this; // NoeudVariableDefinie : déjà sûrement définie
+    return optimiseur.lire(this);
+}
+
+uint32_t NoeudVariable::aplatir(ArbrePlat & plat) {
+    return plat.ajouter(P_VARIABLE, m_case);
+}
+
+NoeudVariableDefinie::NoeudVariableDefinie(Cadre & cadre, unsigned int numeroCase)
+: NoeudVariable(cadre, numeroCase) {
+    m_specialise = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// NoeudEntier
+////////////////////////////////////////////////////////////////////////////////
+
+NoeudEntier::NoeudEntier(int valeur) : Noeud(Genre::ENTIER), m_valeur(valeur) {
+}
+
+void NoeudEntier::traduitEnCPP(std::ostream& cout, unsigned int indentation) const {
+    cout << m_valeur;
+}
+
+uint32_t NoeudEntier::aplatir(ArbrePlat & plat) {
+    return plat.ajouter(P_ENTIER, (uint32_t) m_valeur);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// NoeudChaine
+////////////////////////////////////////////////////////////////////////////////
+
+NoeudChaine::NoeudChaine(string_view texte) : Noeud(Genre::CHAINE), m_texte(texte) {
+}
+
+int NoeudChaine::executer() {
+    throw OperationInterditeException();
+}
+
+void NoeudChaine::traduitEnCPP(std::ostream& cout, unsigned int indentation) const {
+    cout << '"' << m_texte << '"';
+}
+
+uint32_t NoeudChaine::aplatir(ArbrePlat & plat) {
+    return plat.ajouterChaine(m_texte);
+}
@@ -4,26 +4,83 @@
 // Contient toutes les déclarations de classes nécessaires
 //  pour représenter l'arbre abstrait
 
+#include <cstdint>
+#include <functional>
 #include <vector>
 #include <iostream>
 #include <iomanip>
-#include <typeinfo>
 using namespace std;
 
 #include "Symbole.h"
 #include "Exceptions.h"
+#include "Cadre.h"
+#include "Arene.h"
+
+class ArbrePlat;
+class Optimiseur;
+
+// Les classes de l'arbre abstrait, et le genre de leurs noeuds (voir Noeud::getGenre et Visiteur.h) ;
+//  les formes spécialisées (voir Operations.h) ont le genre de la classe dont elles dérivent
+#define GENRES(X) \
+    X(SEQUENCE, NoeudSeqInst) X(AFFECTATION, NoeudAffectation) X(OPERATION, NoeudOperateurBinaire) \
+    X(LOGIQUE, NoeudOperateurLogique) X(UNAIRE, NoeudOperateurUnaire) X(SI, NoeudInstSi) \
+    X(TANTQUE, NoeudInstTantQue) X(REPETER, NoeudInstRepeter) X(POUR, NoeudInstPour) \
+    X(BOUCLE_CALCULEE, NoeudBoucleCalculee) X(ECRIRE, NoeudInstEcrire) X(SI_RICHE, NoeudInstSiRiche) \
+    X(LIRE, NoeudInstLire) X(VARIABLE, NoeudVariable) X(ENTIER, NoeudEntier) X(CHAINE, NoeudChaine) \
+    X(SYMBOLE, SymboleValue)
+
+#define X(genre, classe) class classe;
+GENRES(X)
+#undef X
+
+enum class Genre : uint8_t {
+#define X(genre, classe) genre,
+    GENRES(X)
+#undef X
+}; // Le genre d'un noeud : la classe de l'arbre abstrait à laquelle il appartient
+
+const char* nomGenre(Genre genre); // Le nom de la classe des noeuds de ce genre
 
 ////////////////////////////////////////////////////////////////////////////////
 class Noeud {
 // Classe abstraite dont dériveront toutes les classes servant à représenter l'arbre abstrait
-// Remarque : la classe ne contient aucun constructeur
+// Remarque : seules les classes dérivées construisent un noeud, en lui donnant son genre ; les passes
+//  qui traitent chaque genre à sa façon l'aiguillent sur ce genre (voir Visiteur.h), sans typeid
   public:
+    inline Genre getGenre() const {
+        return m_genre;
+    } // accesseur
+
+    inline bool estSpecialise() const {
+        return m_specialise;
+    } // indique si le noeud est une forme spécialisée de sa classe (voir Operations.h, NoeudVariableDefinie)
+
     virtual int  executer() =0 ; // Méthode pure (non implémentée) qui rend la classe abstraite
     virtual void ajoute(Noeud* instruction) { throw OperationInterditeException(); }
+    virtual void affecter(int valeur) { throw OperationInterditeException(); } // Seules les variables s'affectent
+    virtual Noeud* resoudre(Cadre & cadre, Arene & arene) { return this; }
+    // Passe de résolution, après l'analyse : attribue une case de cadre à chaque variable et renvoie
+    //  le noeud qui remplace celui-ci dans l'arbre (lui-même, sauf pour une variable de la table ou une
+    //  opération spécialisée) ; les noeuds de remplacement sont créés dans arene
+    // Les passes optimiser (option -O) et parcourirFils ne sont pas virtuelles : chaque classe qui en a besoin
+    //  les définit, et elles sont aiguillées sur le genre du noeud (voir Optimiseur::optimiserFils et
+    //  parcourirFils dans Visiteur.h)
+    virtual uint32_t aplatir(ArbrePlat & plat); // Ajoute le noeud (après ses fils) à l'arbre aplati et renvoie son indice
+    //  (par défaut, un noeud délégué : l'arbre aplati appellera ses méthodes executer et traduitEnCPP)
     virtual ~Noeud() {} // Présence d'un destructeur virtuel conseillée dans les classes abstraites
     virtual void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const {
-        sortie << setw(indentation*4) << "" << "traduit en CPP pas défini pour la classe "<<typeid(*this).name() << endl;
+        sortie << setw(indentation*4) << "" << "traduit en CPP pas défini pour la classe "<<nomGenre(m_genre) << endl;
     }
+
+  protected:
+    Noeud(Genre genre) : m_genre(genre), m_specialise(false) {
+    } // Construit un noeud du genre genre, de la forme générale
+
+    Noeud(const Noeud & noeud) : m_genre(noeud.m_genre), m_specialise(false) {
+    } // La copie d'un noeud (pour le remplacer par une autre forme) est de la forme générale
+
+    const Genre m_genre; // La classe du noeud
+    bool m_specialise; // Vrai pour une forme spécialisée, mis par son constructeur
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -35,7 +92,15 @@ class NoeudSeqInst : public Noeud {
     ~NoeudSeqInst() {} // A cause du destructeur virtuel de la classe Noeud
     int executer();    // Exécute chaque instruction de la séquence
     void ajoute(Noeud* instruction);  // Ajoute une instruction à la séquence
+    Noeud* resoudre(Cadre & cadre, Arene & arene);
+    Noeud* optimiser(Optimiseur & optimiseur);
+    void parcourirFils(const function<void(Noeud*)> & action) const;
+    uint32_t aplatir(ArbrePlat & plat);
     void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const;
+
+    inline const vector<Noeud *> & getInstructions() const {
+        return m_instructions;
+    } // accesseur (voir executerCorps dans Operations.h)
     
   private:
     vector<Noeud *> m_instructions; // pour stocker les instructions de la séquence
@@ -49,8 +114,20 @@ class NoeudAffectation : public Noeud {
      NoeudAffectation(Noeud* variable, Noeud* expression); // construit une affectation
     ~NoeudAffectation() {} // A cause du destructeur virtuel de la classe Noeud
     int executer();        // Exécute (évalue) l'expression et affecte sa valeur à la variable
+    Noeud* resoudre(Cadre & cadre, Arene & arene);
+    Noeud* optimiser(Optimiseur & optimiseur);
+    void parcourirFils(const function<void(Noeud*)> & action) const;
+    uint32_t aplatir(ArbrePlat & plat);
     void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const;
 
+    inline Noeud* getVariable() const {
+        return m_variable;
+    } // accesseur
+
+    inline Noeud* getExpression() const {
+        return m_expression;
+    } // accesseur
+
   private:
     Noeud* m_variable;
     Noeud* m_expression;
@@ -65,14 +142,90 @@ class NoeudOperateurBinaire : public Noeud {
     // Construit une opération binaire : operandeGauche operateur OperandeDroit
    ~NoeudOperateurBinaire() {} // A cause du destructeur virtuel de la classe Noeud
     int executer();            // Exécute (évalue) l'opération binaire)
+    Noeud* resoudre(Cadre & cadre, Arene & arene); // Résout les opérandes, puis spécialise l'opération (voir Operations.h) ;
+    //  une opération partagée (voir TableExpressions) n'est résolue qu'une fois
+    Noeud* optimiser(Optimiseur & optimiseur); // Optimise les opérandes, puis plie ou simplifie l'opération (voir Optimiseur)
+    void parcourirFils(const function<void(Noeud*)> & action) const;
+    uint32_t aplatir(ArbrePlat & plat);
+    void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const;
+
+    inline const Symbole & getOperateur() const {
+        return m_operateur;
+    } // accesseur
+
+    inline Noeud* getOperandeGauche() const {
+        return m_operandeGauche;
+    } // accesseur
+
+    inline Noeud* getOperandeDroit() const {
+        return m_operandeDroit;
+    } // accesseur
+
+  private:
+    Symbole m_operateur;
+    Noeud*  m_operandeGauche;
+    Noeud*  m_operandeDroit;
+    Noeud*  m_resolue; // L'opération spécialisée qui la remplace, partagée par toutes ses occurrences résolues
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class NoeudOperateurLogique : public Noeud {
+// Classe pour représenter un noeud "opération logique" et ou ou, et ses 2 fils :
+//  l'opérande droit n'est évalué que si l'opérande gauche ne suffit pas à décider (évaluation paresseuse)
+  public:
+    NoeudOperateurLogique(Symbole operateur, Noeud* operandeGauche, Noeud* operandeDroit);
+   ~NoeudOperateurLogique() {} // A cause du destructeur virtuel de la classe Noeud
+    int executer();            // Évalue l'opération : 1 si elle est vraie, 0 sinon
+    Noeud* resoudre(Cadre & cadre, Arene & arene);
+    Noeud* optimiser(Optimiseur & optimiseur);
+    void parcourirFils(const function<void(Noeud*)> & action) const;
+    uint32_t aplatir(ArbrePlat & plat);
     void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const;
 
+    inline const Symbole & getOperateur() const {
+        return m_operateur;
+    } // accesseur
+
+    inline Noeud* getOperandeGauche() const {
+        return m_operandeGauche;
+    } // accesseur
+
+    inline Noeud* getOperandeDroit() const {
+        return m_operandeDroit;
+    } // accesseur
+
   private:
     Symbole m_operateur;
     Noeud*  m_operandeGauche;
     Noeud*  m_operandeDroit;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+class NoeudOperateurUnaire : public Noeud {
+// Classe pour représenter un noeud "opération unaire" (non, moins) et son fils, l'opérande
+  public:
+    NoeudOperateurUnaire(Symbole operateur, Noeud* operande);
+   ~NoeudOperateurUnaire() {} // A cause du destructeur virtuel de la classe Noeud
+    int executer();            // Évalue l'opération
+    Noeud* resoudre(Cadre & cadre, Arene & arene);
+    Noeud* optimiser(Optimiseur & optimiseur);
+    void parcourirFils(const function<void(Noeud*)> & action) const;
+    uint32_t aplatir(ArbrePlat & plat);
+    void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const;
+
+    inline const Symbole & getOperateur() const {
+        return m_operateur;
+    } // accesseur
+
+    inline Noeud* getOperande() const {
+        return m_operande;
+    } // accesseur
+
+  private:
+    Symbole m_operateur;
+    Noeud*  m_operande;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 class NoeudInstSi : public Noeud {
 // Classe pour représenter un noeud "instruction si"
@@ -82,6 +235,11 @@ class NoeudInstSi : public Noeud {
      // Construit une "instruction si" avec sa condition et sa séquence d'instruction
    ~NoeudInstSi() {} // A cause du destructeur virtuel de la classe Noeud
     int executer();  // Exécute l'instruction si : si condition vraie on exécute la séquence
+    Noeud* resoudre(Cadre & cadre, Arene & arene);
+    Noeud* optimiser(Optimiseur & optimiseur); // Remplacé par sa séquence (ou rien) si sa condition est constante
+    void parcourirFils(const function<void(Noeud*)> & action) const;
+    uint32_t aplatir(ArbrePlat & plat); // Un si riche à une seule branche
+    void traduitEnCPP(ostream & cout, unsigned int indentation) const;
 
   private:
     Noeud*  m_condition;
@@ -98,8 +256,16 @@ class NoeudInstTantQue : public Noeud {
    ~NoeudInstTantQue() {} // A cause du destructeur virtuel de la classe Noeud
     int executer();  // Exécute l'instruction tantque : tantque condition vraie on exécute la séquence
     void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const;
+    Noeud* resoudre(Cadre & cadre, Arene & arene);
+    Noeud* optimiser(Optimiseur & optimiseur);
+    void parcourirFils(const function<void(Noeud*)> & action) const;
+    uint32_t aplatir(ArbrePlat & plat);
 
-  private:
+    inline Noeud* getCondition() const {
+        return m_condition;
+    } // accesseur
+
+  protected: // les formes spécialisées (voir Operations.h) n'en changent que l'exécution
     Noeud*  m_condition;
     Noeud*  m_sequence;
 };
@@ -114,8 +280,16 @@ class NoeudInstRepeter: public Noeud {
     ~NoeudInstRepeter() {} // A cause du destructeur virtuel de la classe Noeud
     int executer();  // Exécute l'instruction tantque : tantque condition vraie on exécute la séquence
     void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const;
+    Noeud* resoudre(Cadre & cadre, Arene & arene);
+    Noeud* optimiser(Optimiseur & optimiseur);
+    void parcourirFils(const function<void(Noeud*)> & action) const;
+    uint32_t aplatir(ArbrePlat & plat);
 
-  private:
+    inline Noeud* getCondition() const {
+        return m_condition;
+    } // accesseur
+
+  protected: // les formes spécialisées (voir Operations.h) n'en changent que l'exécution
     Noeud*  m_condition;
     Noeud*  m_sequence;
 };
@@ -129,14 +303,72 @@ class NoeudInstPour: public Noeud {
     ~NoeudInstPour() {} // A cause du destructeur virtuel de la classe Noeud
     int executer();  // Exécute l'instruction tantque : tantque condition vraie on exécute la séquence
     void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const;
+    Noeud* resoudre(Cadre & cadre, Arene & arene);
+    Noeud* optimiser(Optimiseur & optimiseur);
+    void parcourirFils(const function<void(Noeud*)> & action) const;
+    uint32_t aplatir(ArbrePlat & plat);
 
-  private:
+    inline Noeud* getCondition() const {
+        return m_condition;
+    } // accesseur
+
+  protected: // les formes spécialisées (voir Operations.h) n'en changent que l'exécution
     Noeud*  m_affecter;
     Noeud*  m_condition;
     Noeud*  m_action;
     Noeud*  m_sequence;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+struct Recurrence {
+    vector<unsigned int> variables; // Les cases des variables affectées dans la boucle (dont le compteur)
+    vector<NoeudAffectation*> iteration; // Les affectations d'une itération, dans l'ordre d'exécution
+    vector<unsigned int> entree; // Les cases des variables lues avant d'être affectées dans une itération
+    unsigned int compteur; // La case du compteur, comparé à la borne par la condition
+    CodeSymbole comparaison; // compteur comparaison borne : S_INFERIEUR, S_INFERIEUREGAL, S_SUPERIEUR ou S_SUPERIEUREGAL
+    Noeud* borne; // Un entier, ou une variable qui n'est pas affectée dans la boucle
+}; // Description d'une boucle calculable, établie par l'optimiseur (voir Optimiseur::calculerBoucle)
+
+class NoeudBoucleCalculee : public Noeud {
+// Classe pour représenter une boucle tantque ou pour dont chaque itération n'est qu'une suite d'affectations
+//  affines (sommes, différences, produits par une valeur qui ne change pas dans la boucle), et dont la condition
+//  compare un compteur à une borne qui ne change pas. Une itération est alors une application affine des
+//  variables de la boucle, modulo 2^32 comme les calculs de l'interpréteur : n itérations sont sa puissance
+//  n-ième, calculée en O(log n). Si le nombre d'itérations n'est pas connu exactement (compteur qui déborde ou
+//  ne va pas vers la borne, variable lue indéfinie), ou s'il est petit, la boucle s'exécute normalement.
+  public:
+    NoeudBoucleCalculee(Noeud* boucle, Noeud* affecter, Noeud* condition, Noeud* sequence, Noeud* action,
+            Cadre & cadre, const Recurrence & recurrence);
+     // Construit le calcul de boucle (la boucle d'origine), dont les fils affecter et action peuvent être absents
+    ~NoeudBoucleCalculee() {} // A cause du destructeur virtuel de la classe Noeud
+    int executer();  // Exécute l'affectation, puis calcule l'effet de la boucle, ou l'exécute s'il ne peut pas
+    void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const; // Traduit la boucle d'origine
+    void parcourirFils(const function<void(Noeud*)> & action) const;
+
+    inline Noeud* getBoucle() const {
+        return m_boucle;
+    } // accesseur
+
+  private:
+    bool calculer(); // Calcule l'effet de la boucle si c'est possible et utile ; sinon, renvoie faux sans rien changer
+    void construireMatrice(); // Calcule la matrice d'une itération, pour les valeurs courantes des variables invariantes
+    void forme(Noeud* expression, const vector<vector<uint32_t> > & etat, vector<uint32_t> & resultat) const;
+    // Forme affine de expression : ses coefficients sur les variables de la boucle à l'entrée de l'itération
+    //  (dont l'état courant est etat), puis sa constante
+
+    Noeud*  m_boucle;
+    Noeud*  m_affecter;
+    Noeud*  m_condition;
+    Noeud*  m_sequence;
+    Noeud*  m_action;
+    Cadre & m_cadre;
+    Recurrence m_recurrence;
+    vector<int> m_rangs; // Le rang, dans m_recurrence.variables, de chaque case (-1 si elle n'y est pas)
+    vector<unsigned int> m_invariantes; // Les cases lues qui ne sont pas affectées dans la boucle
+    vector<int> m_valeursInvariantes; // Leurs valeurs quand la matrice a été calculée
+    vector<uint32_t> m_matrice; // La matrice d'une itération (vide tant qu'elle n'a pas été calculée)
+};
+
 
 ////////////////////////////////////////////////////////////////////////////////
 class NoeudInstEcrire: public Noeud {
@@ -150,6 +382,10 @@ class NoeudInstEcrire: public Noeud {
     void ajoute(Noeud* parametre);
     int executer();  // Exécute l'instruction ecrire
     void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const;
+    Noeud* resoudre(Cadre & cadre, Arene & arene);
+    Noeud* optimiser(Optimiseur & optimiseur);
+    void parcourirFils(const function<void(Noeud*)> & action) const;
+    uint32_t aplatir(ArbrePlat & plat);
 
   private:
       vector<Noeud*> m_vecteurEcrire;
@@ -166,8 +402,12 @@ class NoeudInstSiRiche: public Noeud {
     void ajouter(Noeud* instruction);
     int executer();  // Exécute l'instruction siRiche
     void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const;    
+    Noeud* resoudre(Cadre & cadre, Arene & arene);
+    Noeud* optimiser(Optimiseur & optimiseur); // Supprime les branches dont la condition est constante
+    void parcourirFils(const function<void(Noeud*)> & action) const;
+    uint32_t aplatir(ArbrePlat & plat);
 
-  private:
+  protected: // les formes spécialisées (voir Operations.h) n'en changent que l'exécution
       vector<Noeud*> m_vecteurConditonInstruction;
 
 };
@@ -180,10 +420,110 @@ public:
     void ajoute(Noeud* variable) override;
     virtual ~NoeudInstLire() {}
     void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const;
+    Noeud* resoudre(Cadre & cadre, Arene & arene);
+    Noeud* optimiser(Optimiseur & optimiseur); // Les variables lues deviennent définies
+    void parcourirFils(const function<void(Noeud*)> & action) const;
+    uint32_t aplatir(ArbrePlat & plat);
     
 private:
     vector<Noeud*> m_varLire;
 };
+////////////////////////////////////////////////////////////////////////////////
+class NoeudVariable : public Noeud {
+// Classe pour représenter une variable résolue : une feuille qui désigne une case du cadre
+//  (elle remplace dans l'arbre le symbole valué de la variable, voir SymboleValue::resoudre)
+public:
+    NoeudVariable(Cadre & cadre, unsigned int numeroCase); // Construit la feuille de la case numeroCase de cadre
+    ~NoeudVariable() {} // A cause du destructeur virtuel de la classe Noeud
+
+    inline int executer() override {
+        return m_cadre.getValeur(m_case);
+    } // renvoie la valeur de la case (exception si elle n'est pas définie)
+
+    inline void affecter(int valeur) override final {
+        m_cadre.setValeur(m_case, valeur);
+    } // affecte valeur à la case
+
+    void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const;
+    Noeud* optimiser(Optimiseur & optimiseur); // Une lecture sûrement définie devient une NoeudVariableDefinie
+    uint32_t aplatir(ArbrePlat & plat);
+
+    inline Cadre & getCadre() const {
+        return m_cadre;
+    } // accesseur
+
+    inline unsigned int getCase() const {
+        return m_case;
+    } // accesseur
+
+protected:
+    Cadre & m_cadre; // Le cadre qui contient la valeur de la variable
+    unsigned int m_case; // Le numéro de la case de la variable dans le cadre
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class NoeudVariableDefinie final : public NoeudVariable {
+// Classe pour représenter la lecture d'une variable dont l'optimiseur a prouvé qu'elle est définie à cet
+//  endroit (voir Optimiseur::lire) : sa valeur est lue sans vérification. Pour les analyses, c'est une
+//  variable comme une autre (même genre, voir estVariable), de la forme spécialisée.
+public:
+    NoeudVariableDefinie(Cadre & cadre, unsigned int numeroCase); // Construit la lecture de la case numeroCase de cadre
+    ~NoeudVariableDefinie() {} // A cause du destructeur virtuel de la classe Noeud
+
+    inline int executer() override {
+        return m_cadre.getValeurDefinie(m_case);
+    } // renvoie la valeur de la case
+};
+
+inline bool estVariable(const Noeud* noeud) {
+    return noeud->getGenre() == Genre::VARIABLE;
+} // indique si noeud est une variable résolue, lue avec ou sans vérification
+
+inline NoeudOperateurBinaire* enOperation(Noeud* noeud) {
+    return noeud->getGenre() == Genre::OPERATION ? (NoeudOperateurBinaire *) noeud : nullptr;
+} // noeud s'il est une opération binaire (ou l'une de ses formes spécialisées), nullptr sinon
+
+////////////////////////////////////////////////////////////////////////////////
+class NoeudEntier : public Noeud {
+// Classe pour représenter un entier littéral : une feuille qui contient directement sa valeur
+//  (voir TableLitteraux)
+public:
+    NoeudEntier(int valeur); // Construit la feuille de l'entier valeur
+    ~NoeudEntier() {} // A cause du destructeur virtuel de la classe Noeud
+
+    inline int executer() override {
+        return m_valeur;
+    } // renvoie la valeur de l'entier
+
+    inline int getValeur() const {
+        return m_valeur;
+    } // accesseur
+
+    void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const;
+    uint32_t aplatir(ArbrePlat & plat);
+
+private:
+    int m_valeur; // La valeur de l'entier, convertie une fois pour toutes à l'analyse
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class NoeudChaine : public Noeud {
+// Classe pour représenter une chaîne littérale, paramètre de ecrire (voir TableLitteraux)
+public:
+    NoeudChaine(string_view texte); // Construit la feuille de la chaîne texte (sans ses guillemets)
+    ~NoeudChaine() {} // A cause du destructeur virtuel de la classe Noeud
+    int executer() override; // Une chaîne n'a pas de valeur entière : lève une exception
+
+    inline const string & getTexte() const {
+        return m_texte;
+    } // accesseur
+
+    void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const;
+    uint32_t aplatir(ArbrePlat & plat);
+
+private:
+    string m_texte; // Le texte de la chaîne, sans ses guillemets
+};
 
 
 
@@ -0,0 +1,270 @@
+#include "ArbrePlat.h"
+#include "ArbreAbstrait.h"
+#include "Symbole.h"
+#include "Exceptions.h"
+#include "Operations.h"
+#include <algorithm>
+#include <iomanip>
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+ArbrePlat::ArbrePlat(Noeud & racine, Cadre & cadre) :
+m_noeuds(), m_listes(), m_chaines(), m_externes(), m_cadre(cadre), m_racine(AUCUN) {
+  m_racine = racine.aplatir(*this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t ArbrePlat::ajouter(GenrePlat genre, uint32_t a, uint32_t b, uint8_t code) {
+  m_noeuds.push_back({genre, code, a, b});
+  return m_noeuds.size() - 1;
+}
+
+uint32_t ArbrePlat::ajouterListe(GenrePlat genre, const vector<uint32_t> & fils) {
+  uint32_t debut = m_listes.size();
+  m_listes.insert(m_listes.end(), fils.begin(), fils.end());
+  return ajouter(genre, debut, fils.size());
+}
+
+uint32_t ArbrePlat::ajouterChaine(const string & texte) {
+  m_chaines.push_back(texte);
+  return ajouter(P_CHAINE, m_chaines.size() - 1);
+}
+
+uint32_t ArbrePlat::ajouterExterne(Noeud * noeud) {
+  m_externes.push_back(noeud);
+  return ajouter(P_EXTERNE, m_externes.size() - 1);
+}
+
+uint32_t ArbrePlat::selon(const NoeudPlat & n, vector<uint32_t> & cles) const {
+  // Mêmes règles que specialiserSiRiche, pour que la traduction soit la même que celle de l'arbre
+  uint32_t variable = AUCUN;
+  vector<int> valeurs;
+  cles.clear();
+  if (n.b / 2 < NoeudInstSelon::BRANCHES_MIN) return AUCUN;
+  for (uint32_t j = 0; j + 2 <= n.b; j += 2) {
+    const NoeudPlat & egalite = m_noeuds[getFils(n, j)];
+    if (egalite.genre != P_OPERATEUR || egalite.code != S_EGAL) return AUCUN;
+    uint32_t gauche = egalite.a, droit = egalite.b;
+    if (m_noeuds[gauche].genre == P_ENTIER) swap(gauche, droit);
+    if (m_noeuds[gauche].genre != P_VARIABLE || m_noeuds[droit].genre != P_ENTIER) return AUCUN;
+    if (variable == AUCUN) variable = gauche;
+    else if (m_noeuds[gauche].a != m_noeuds[variable].a) return AUCUN;
+    cles.push_back(droit);
+    valeurs.push_back((int) m_noeuds[droit].a);
+  }
+  sort(valeurs.begin(), valeurs.end());
+  return adjacent_find(valeurs.begin(), valeurs.end()) == valeurs.end() ? variable : AUCUN;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int ArbrePlat::executer() {
+  return executer(m_racine);
+}
+
+int ArbrePlat::executer(uint32_t i) {
+  const NoeudPlat & n = m_noeuds[i];
+  switch (n.genre) {
+    case P_SEQUENCE:
+      for (uint32_t j = 0; j < n.b; j++) executer(getFils(n, j)); // on exécute chaque instruction de la séquence
+      return 0;
+    case P_AFFECTATION:
+      affecter(n.a, executer(n.b));
+      return 0;
+    case P_OPERATEUR: {
+      int og = executer(n.a);
+      return calculer((CodeSymbole) n.code, og, executer(n.b));
+    }
+    case P_LOGIQUE:
+      if (n.code == S_ET) return executer(n.a) && executer(n.b);
+      return executer(n.a) || executer(n.b);
+    case P_UNAIRE:
+      return calculerUnaire((CodeSymbole) n.code, executer(n.a));
+    case P_SIRICHE: { // fils : condition, séquence, condition, séquence..., [séquence du sinon]
+      uint32_t fin = (n.b % 2) ? n.b - 1 : n.b;
+      for (uint32_t j = 0; j < fin; j += 2)
+        if (executer(getFils(n, j))) return executer(getFils(n, j + 1)); // première condition vraie
+      if (n.b % 2) executer(getFils(n, n.b - 1));
+      return 0;
+    }
+    case P_TANTQUE:
+      while (executer(n.a)) executer(n.b);
+      return 0;
+    case P_REPETER:
+      do {
+        executer(n.a);
+      } while (!executer(n.b));
+      return 0;
+    case P_POUR: {
+      uint32_t affecter = getFils(n, 0), condition = getFils(n, 1), action = getFils(n, 2), sequence = getFils(n, 3);
+      for (affecter == AUCUN ? 0 : executer(affecter); executer(condition); action == AUCUN ? 0 : executer(action))
+        executer(sequence);
+      return 0;
+    }
+    case P_ECRIRE:
+      for (uint32_t j = 0; j < n.b; j++) {
+        const NoeudPlat & parametre = m_noeuds[getFils(n, j)];
+        if (parametre.genre == P_CHAINE) cout << m_chaines[parametre.a];
+        else cout << executer(getFils(n, j));
+      }
+      return 0;
+    case P_LIRE:
+      for (uint32_t j = 0; j < n.b; j++) {
+        int valeur;
+        cin >> valeur;
+        affecter(getFils(n, j), valeur);
+      }
+      return 0;
+    case P_VARIABLE:
+      return m_cadre.getValeur(n.a);
+    case P_ENTIER:
+      return (int) n.a;
+    case P_CHAINE:
+      throw OperationInterditeException(); // une chaîne n'a pas de valeur entière
+    case P_EXTERNE:
+      return m_externes[n.a]->executer();
+  }
+  return 0;
+}
+
+void ArbrePlat::affecter(uint32_t i, int valeur) {
+  const NoeudPlat & n = m_noeuds[i];
+  if (n.genre == P_VARIABLE) m_cadre.setValeur(n.a, valeur);
+  else if (n.genre == P_EXTERNE) m_externes[n.a]->affecter(valeur);
+  else throw OperationInterditeException();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ArbrePlat::traduitEnCPP(ostream & sortie, unsigned int indentation) const {
+  traduitEnCPP(m_racine, sortie, indentation);
+}
+
+void ArbrePlat::traduitEnCPP(uint32_t i, ostream & cout, unsigned int indentation) const {
+  // Chaque cas produit exactement le texte de la méthode traduitEnCPP de la classe de noeud correspondante
+  const NoeudPlat & n = m_noeuds[i];
+  switch (n.genre) {
+    case P_SEQUENCE:
+      for (uint32_t j = 0; j < n.b; j++) {
+        GenrePlat genre = m_noeuds[getFils(n, j)].genre;
+        traduitEnCPP(getFils(n, j), cout, indentation);
+        if (genre == P_AFFECTATION || genre == P_ECRIRE || genre == P_LIRE) cout << ";";
+        cout << endl;
+      }
+      break;
+    case P_AFFECTATION:
+      cout << setw(4 * indentation) << "";
+      traduitEnCPP(n.a, cout, 0);
+      cout << "=";
+      traduitEnCPP(n.b, cout, 0);
+      break;
+    case P_OPERATEUR:
+    case P_LOGIQUE:
+      cout << setw(4 * indentation) << "" << "(";
+      traduitEnCPP(n.a, cout, 0);
+      cout << " " << operateurCPP((CodeSymbole) n.code) << " ";
+      traduitEnCPP(n.b, cout, 0);
+      cout << ")";
+      break;
+    case P_UNAIRE:
+      cout << setw(4 * indentation) << "" << "(" << operateurCPP((CodeSymbole) n.code);
+      traduitEnCPP(n.a, cout, 0);
+      cout << ")";
+      break;
+    case P_SIRICHE: {
+      vector<uint32_t> cles;
+      uint32_t variable = selon(n, cles);
+      if (variable != AUCUN) { // même texte que NoeudInstSelon::traduitEnCPP
+        cout << setw(4 * indentation) << "" << "switch (";
+        traduitEnCPP(variable, cout, 0);
+        cout << ") {" << endl;
+        for (uint32_t j = 0; j < cles.size(); j++) {
+          cout << setw(4 * (indentation + 1)) << "" << "case ";
+          traduitEnCPP(cles[j], cout, 0);
+          cout << ": {" << endl;
+          traduitEnCPP(getFils(n, 2 * j + 1), cout, indentation + 2);
+          cout << setw(4 * (indentation + 1)) << "" << "} break;" << endl;
+        }
+        if (n.b % 2) {
+          cout << setw(4 * (indentation + 1)) << "" << "default: {" << endl;
+          traduitEnCPP(getFils(n, n.b - 1), cout, indentation + 2);
+          cout << setw(4 * (indentation + 1)) << "" << "}" << endl;
+        }
+        cout << setw(4 * indentation) << "" << "}";
+        break;
+      }
+      uint32_t j = 0;
+      cout << setw(4 * indentation) << "" << "if (";
+      traduitEnCPP(getFils(n, j++), cout, 0);
+      cout << ") {" << endl;
+      traduitEnCPP(getFils(n, j++), cout, indentation + 1);
+      cout << setw(4 * indentation) << "" << "}";
+      while (j + 2 <= n.b) {
+        cout << " else if (";
+        traduitEnCPP(getFils(n, j++), cout, 0);
+        cout << ") {" << endl;
+        traduitEnCPP(getFils(n, j++), cout, indentation + 1);
+        cout << setw(4 * indentation) << "" << "}";
+      }
+      if (n.b % 2) {
+        cout << " else {" << endl;
+        traduitEnCPP(getFils(n, n.b - 1), cout, indentation + 1);
+        cout << setw(4 * indentation) << "" << "}";
+      }
+      break;
+    }
+    case P_TANTQUE:
+      cout << setw(4 * indentation) << "" << "while (";
+      traduitEnCPP(n.a, cout, 0);
+      cout << ") {" << endl;
+      traduitEnCPP(n.b, cout, indentation + 1);
+      cout << setw(4 * indentation) << "" << "}";
+      break;
+    case P_REPETER:
+      cout << setw(4 * indentation) << "" << "do {" << endl;
+      traduitEnCPP(n.a, cout, indentation + 1);
+      cout << setw(4 * indentation) << "" << "} while (!";
+      traduitEnCPP(n.b, cout, 0);
+      cout << ");";
+      break;
+    case P_POUR:
+      cout << setw(4 * indentation) << "" << "for (";
+      if (getFils(n, 0) != AUCUN) traduitEnCPP(getFils(n, 0), cout, 0);
+      cout << "; ";
+      traduitEnCPP(getFils(n, 1), cout, 0);
+      cout << "; ";
+      if (getFils(n, 2) != AUCUN) traduitEnCPP(getFils(n, 2), cout, 0);
+      cout << ") {" << endl;
+      traduitEnCPP(getFils(n, 3), cout, indentation + 1);
+      cout << setw(4 * indentation) << "" << "}";
+      break;
+    case P_ECRIRE:
+      cout << setw(4 * indentation) << "" << "cout";
+      for (uint32_t j = 0; j < n.b; j++) {
+        cout << " << ";
+        traduitEnCPP(getFils(n, j), cout, 0);
+      }
+      break;
+    case P_LIRE:
+      cout << setw(4 * indentation) << "" << "cin";
+      for (uint32_t j = 0; j < n.b; j++) {
+        cout << " >> ";
+        traduitEnCPP(getFils(n, j), cout, 0);
+      }
+      break;
+    case P_VARIABLE:
+      cout << m_cadre.getNom(n.a);
+      break;
+    case P_ENTIER:
+      cout << (int) n.a;
+      break;
+    case P_CHAINE:
+      cout << '"' << m_chaines[n.a] << '"';
+      break;
+    case P_EXTERNE:
+      m_externes[n.a]->traduitEnCPP(cout, indentation);
+      break;
+  }
+}
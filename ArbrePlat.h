@@ -0,0 +1,103 @@
+#ifndef ARBREPLAT_H
+#define ARBREPLAT_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "Cadre.h"
+
+class Noeud;
+
+// Genre d'un noeud de l'arbre aplati : un par classe de noeud de l'arbre abstrait,
+// plus P_EXTERNE pour un noeud que l'on n'aplatit pas et auquel on délègue l'exécution.
+enum GenrePlat : uint8_t {
+    P_SEQUENCE, P_AFFECTATION, P_OPERATEUR, P_LOGIQUE, P_UNAIRE, P_SIRICHE, P_TANTQUE, P_REPETER, P_POUR, P_ECRIRE, P_LIRE,
+    P_VARIABLE, P_ENTIER, P_CHAINE, P_EXTERNE
+};
+
+// Noeud de l'arbre aplati : 12 octets, sans pointeur, les fils étant désignés par leur indice.
+//   P_SEQUENCE, P_SIRICHE, P_ECRIRE, P_LIRE : a = début et b = nombre des fils dans la table des listes
+//   P_POUR        : a = début de la liste affecter, condition, action, séquence
+//   P_AFFECTATION : a = variable, b = expression
+//   P_OPERATEUR   : code = opérateur, a = opérande gauche, b = opérande droit
+//   P_LOGIQUE     : code = S_ET ou S_OU, a = opérande gauche, b = opérande droit (évalué au besoin)
+//   P_UNAIRE      : code = S_NON ou S_MOINS, a = opérande
+//   P_TANTQUE     : a = condition, b = séquence ; P_REPETER : a = séquence, b = condition
+//   P_VARIABLE    : a = case du cadre ; P_ENTIER : a = valeur ; P_CHAINE : a = indice de la chaîne
+//   P_EXTERNE     : a = indice du noeud délégué
+struct NoeudPlat {
+    GenrePlat genre;
+    uint8_t code; // code de l'opérateur (CodeSymbole) d'un P_OPERATEUR, P_LOGIQUE ou P_UNAIRE
+    uint32_t a, b;
+};
+
+// ArbrePlat est une autre représentation de l'arbre abstrait : tous les noeuds sont rangés dans un seul
+// tableau contigu, dans l'ordre d'exécution (les fils avant leur père, les instructions d'une séquence
+// dans l'ordre), et on l'exécute ou on le traduit en C++ par un aiguillage sur le genre du noeud.
+// Il est construit par Noeud::aplatir ; les variables sont celles du cadre de l'interpréteur.
+
+class ArbrePlat {
+public:
+    static constexpr uint32_t AUCUN = UINT32_MAX; // Indice d'un fils absent
+
+    ArbrePlat(Noeud & racine, Cadre & cadre); // Aplatit l'arbre de racine racine, dont les variables sont dans cadre
+
+    int executer(); // Exécute l'arbre aplati
+    void traduitEnCPP(ostream & sortie, unsigned int indentation) const; // Même traduction que l'arbre abstrait
+
+    // Construction (voir Noeud::aplatir) : chaque méthode renvoie l'indice de ce qu'elle a ajouté
+    uint32_t ajouter(GenrePlat genre, uint32_t a = AUCUN, uint32_t b = AUCUN, uint8_t code = 0);
+    uint32_t ajouterListe(GenrePlat genre, const vector<uint32_t> & fils); // Noeud dont les fils sont dans une liste
+    uint32_t ajouterChaine(const string & texte); // Noeud P_CHAINE
+    uint32_t ajouterExterne(Noeud * noeud); // Noeud P_EXTERNE délégué à noeud
+
+    inline const NoeudPlat & getNoeud(uint32_t i) const {
+        return m_noeuds[i];
+    } // accesseur
+
+    inline uint32_t getFils(const NoeudPlat & noeud, uint32_t j) const {
+        return m_listes[noeud.a + j];
+    } // jème fils d'un noeud dont les fils sont dans la table des listes
+
+    inline uint32_t getNbNoeuds() const {
+        return m_noeuds.size();
+    } // Nombre de noeuds
+
+    inline uint32_t getRacine() const {
+        return m_racine;
+    } // Indice de la racine (le dernier noeud)
+
+    inline const string & getChaine(uint32_t i) const {
+        return m_chaines[i];
+    } // Texte d'une chaîne
+
+    inline Noeud * getExterne(uint32_t i) const {
+        return m_externes[i];
+    } // Noeud délégué
+
+    uint32_t selon(const NoeudPlat & noeud, vector<uint32_t> & cles) const;
+    // Si le P_SIRICHE noeud compare une même variable à des entiers tous différents (voir NoeudInstSelon),
+    //  renvoie l'indice de la variable de sa première condition, et range dans cles l'indice de l'entier de
+    //  chaque condition ; sinon, renvoie AUCUN
+
+    inline Cadre & getCadre() const {
+        return m_cadre;
+    } // Le cadre des variables
+
+private:
+    int executer(uint32_t i); // Exécute (évalue) le noeud i
+    void affecter(uint32_t i, int valeur); // Affecte valeur à la variable désignée par le noeud i
+    void traduitEnCPP(uint32_t i, ostream & sortie, unsigned int indentation) const; // Traduit le noeud i
+
+    vector<NoeudPlat> m_noeuds; // Les noeuds, dans l'ordre d'exécution
+    vector<uint32_t> m_listes; // Les listes de fils des noeuds qui en ont un nombre variable
+    vector<string> m_chaines; // Le texte des chaînes littérales
+    vector<Noeud*> m_externes; // Les noeuds délégués
+    Cadre & m_cadre; // Le cadre des variables
+    uint32_t m_racine; // Indice de la racine
+};
+
+#endif /* ARBREPLAT_H */
@@ -0,0 +1,37 @@
+#include "Arene.h"
+#include <algorithm>
+
+Arene::Arene(size_t tailleBloc) :
+m_tailleBloc(tailleBloc), m_blocs(), m_courant(nullptr), m_fin(nullptr), m_aDetruire() {
+}
+
+Arene::~Arene() {
+  vider();
+  for (char * bloc : m_blocs) ::operator delete(bloc);
+}
+
+void Arene::vider() {
+  for (auto i = m_aDetruire.rbegin(); i != m_aDetruire.rend(); i++)
+    i->detruire(i->objet);
+  m_aDetruire.clear();
+  if (m_blocs.empty()) return;
+  for (size_t i = 1; i < m_blocs.size(); i++) ::operator delete(m_blocs[i]);
+  m_blocs.resize(1); // le premier bloc resservira : une nouvelle analyse du même programme n'alloue presque rien
+  m_courant = m_blocs[0];
+  m_fin = m_courant + m_tailleBloc;
+}
+
+void * Arene::allouerBloc(size_t taille, size_t alignement) {
+  // ::operator new renvoie une adresse alignée pour tout type standard : le début du bloc convient
+  size_t tailleNouveau = max(m_tailleBloc, taille + alignement);
+  char * bloc = (char *) ::operator new(tailleNouveau);
+  if (tailleNouveau > m_tailleBloc && !m_blocs.empty()) {
+    // objet plus grand qu'un bloc : il a son propre bloc, et on continue à remplir le bloc courant
+    m_blocs.insert(m_blocs.end() - 1, bloc);
+    return bloc;
+  }
+  m_blocs.push_back(bloc);
+  m_courant = bloc + taille;
+  m_fin = bloc + tailleNouveau;
+  return bloc;
+}
@@ -0,0 +1,59 @@
+#ifndef ARENE_H
+#define ARENE_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+using namespace std;
+
+// Arene est l'allocateur des objets d'un programme analysé (noeuds de l'arbre, symboles valués, littéraux).
+// Les objets sont placés les uns après les autres dans de grands blocs (allocation par simple incrément
+// d'un pointeur, objets voisins en mémoire), et sont tous libérés d'un coup par vider() ou par le
+// destructeur : l'arène est propriétaire de tout ce qu'elle a créé, aucun objet n'est détruit seul.
+
+class Arene {
+public:
+    Arene(size_t tailleBloc = 64 * 1024); // Construit une arène vide, qui réservera la mémoire par blocs de tailleBloc octets
+    ~Arene(); // Détruit tous les objets créés et libère les blocs
+
+    template <class T, class... Arguments>
+    T* creer(Arguments&&... arguments) {
+        T* objet = new (allouer(sizeof (T), alignof (T))) T(forward<Arguments>(arguments)...);
+        if (!is_trivially_destructible<T>::value) // il faudra appeler son destructeur à la libération
+            m_aDetruire.push_back({objet, [](void * o) { static_cast<T*>(o)->~T(); }});
+        return objet;
+    } // Construit dans l'arène un objet T avec les arguments donnés et renvoie son adresse
+
+    void vider(); // Détruit tous les objets créés (dans l'ordre inverse de création) ; l'arène garde
+                  //  son premier bloc pour les allocations suivantes
+
+private:
+    Arene(const Arene &) = delete;
+    Arene & operator=(const Arene &) = delete;
+
+    inline void * allouer(size_t taille, size_t alignement) {
+        size_t decalage = (alignement - (size_t) m_courant % alignement) % alignement;
+        if (m_courant == nullptr || taille + decalage > (size_t) (m_fin - m_courant))
+            return allouerBloc(taille, alignement);
+        void * place = m_courant + decalage;
+        m_courant += decalage + taille;
+        return place;
+    } // Réserve taille octets alignés sur alignement dans le bloc courant
+
+    void * allouerBloc(size_t taille, size_t alignement); // Réserve taille octets dans un nouveau bloc
+
+    struct Destruction {
+        void * objet;
+        void (*detruire)(void *);
+    }; // Un objet de l'arène et la fonction qui appelle son destructeur
+
+    size_t m_tailleBloc; // Taille normale d'un bloc
+    vector<char *> m_blocs; // Les blocs réservés (le dernier est le bloc courant)
+    char * m_courant; // Premier octet libre du bloc courant
+    char * m_fin; // Fin du bloc courant
+    vector<Destruction> m_aDetruire; // Les objets dont il faudra appeler le destructeur
+};
+
+#endif /* ARENE_H */
@@ -0,0 +1,18 @@
+#include "Cadre.h"
+
+Cadre::Cadre() : m_valeurs(), m_definis(), m_noms() {
+}
+
+unsigned int Cadre::ajouterCase(string_view nom) {
+  unsigned int i = m_valeurs.size();
+  m_valeurs.push_back(0);
+  m_noms.push_back(nom);
+  if ((i & 63) == 0) m_definis.push_back(0); // un mot de bits de plus toutes les 64 cases
+  return i;
+}
+
+void Cadre::vider() {
+  m_valeurs.clear();
+  m_definis.clear();
+  m_noms.clear();
+}
@@ -0,0 +1,66 @@
+#ifndef CADRE_H
+#define CADRE_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+using namespace std;
+#include "Exceptions.h"
+
+// Cadre contient l'état d'exécution d'un programme : la valeur de chacune de ses variables,
+// rangée dans une case d'un tableau contigu d'entiers, et un bit par case indiquant si la valeur
+// est définie. Les cases sont attribuées aux variables une fois pour toutes après l'analyse
+// (voir Noeud::resoudre) : l'arbre désigne alors les variables par leur numéro de case.
+
+class Cadre {
+public:
+    Cadre(); // Construit un cadre sans aucune case
+
+    unsigned int ajouterCase(string_view nom); // Ajoute une case indéfinie pour la variable nom et renvoie son numéro
+    void vider(); // Supprime toutes les cases
+
+    inline unsigned int getTaille() const {
+        return m_valeurs.size();
+    } // Nombre de cases
+
+    inline bool estDefini(unsigned int i) const {
+        return (m_definis[i >> 6] >> (i & 63)) & 1;
+    } // indique si la valeur de la case i est définie
+
+    inline int getValeur(unsigned int i) const {
+        if (!estDefini(i)) throw IndefiniException(); // on lève une exception si valeur non définie
+        return m_valeurs[i];
+    } // valeur de la case i
+
+    inline int getValeurDefinie(unsigned int i) const {
+        return m_valeurs[i];
+    } // valeur de la case i, que l'on sait définie : pas de vérification
+
+    inline void setValeur(unsigned int i, int valeur) {
+        m_valeurs[i] = valeur;
+        definir(i);
+    } // affecte valeur à la case i, qui devient définie
+
+    inline void definir(unsigned int i) {
+        m_definis[i >> 6] |= uint64_t(1) << (i & 63);
+    } // marque la case i comme définie, sans toucher à sa valeur
+
+    inline int * getValeurs() {
+        return m_valeurs.data();
+    } // Tableau des valeurs, pour les moteurs qui les chargent et les rangent d'un bloc (voir MachineVirtuelle)
+
+    inline uint64_t * getDefinis() {
+        return m_definis.data();
+    } // Tableau des bits "défini", pour le code natif qui les teste et les positionne lui-même (voir CodeNatif)
+
+    inline string_view getNom(unsigned int i) const {
+        return m_noms[i];
+    } // nom de la variable rangée dans la case i
+
+private:
+    vector<int> m_valeurs; // Valeur de chaque case (zéro tant qu'elle n'est pas définie)
+    vector<uint64_t> m_definis; // Un bit par case : 1 si sa valeur est définie
+    vector<string_view> m_noms; // Nom de la variable de chaque case (chaîne détenue par la table des symboles)
+};
+
+#endif /* CADRE_H */
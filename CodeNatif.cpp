@@ -0,0 +1,334 @@
+#include "CodeNatif.h"
+#include "ArbreAbstrait.h"
+#include "Exceptions.h"
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+using namespace std;
+
+// Registres du processeur : eax, ecx, edx, esi (32 bits), dans le champ reg de l'octet ModRM
+static const uint8_t EAX = 0, ECX = 1, ESI = 6;
+
+static uint8_t condition(CodeSymbole comparaison) {
+  // Code de condition x86 (setcc, jcc) d'une comparaison signée
+  switch (comparaison) {
+    case S_EGAL: return 0x4;
+    case S_DIFFERENT: return 0x5;
+    case S_INFERIEUR: return 0xC;
+    case S_SUPERIEUREGAL: return 0xD;
+    case S_INFERIEUREGAL: return 0xE;
+    case S_SUPERIEUR: return 0xF;
+    default: return 0x5;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+CodeNatif::CodeNatif(MachineVirtuelle & machine) :
+m_machine(machine), m_octets(), m_sortie(0), m_erreurs(), m_entree(0), m_sauts(), m_zone(nullptr), m_tailleZone(0),
+m_fonction(nullptr), m_registres(), m_exception() {
+#if defined(__x86_64__)
+  if (traduire()) installer();
+#endif
+  m_octets.clear();
+  m_octets.shrink_to_fit();
+  m_sauts.clear();
+}
+
+CodeNatif::~CodeNatif() {
+  if (m_zone != nullptr) munmap(m_zone, m_tailleZone);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int CodeNatif::executer() {
+  if (m_fonction == nullptr) return m_machine.executer();
+  Cadre & cadre = m_machine.getPlat().getCadre();
+  size_t tailleVariables = m_machine.getNbVariables() * sizeof (int32_t);
+  m_registres.assign(m_machine.getNbRegistres(), 0);
+  memcpy(m_registres.data(), cadre.getValeurs(), tailleVariables);
+  int32_t etat = m_fonction(m_registres.data(), cadre.getDefinis(), this);
+  memcpy(cadre.getValeurs(), m_registres.data(), tailleVariables); // même en cas d'erreur, comme la machine
+  switch (etat) {
+    case DIVISION_PAR_ZERO: throw DivParZeroException();
+    case INDEFINI: throw IndefiniException();
+    case INTERDIT: throw OperationInterditeException();
+    case EXCEPTION: {
+      exception_ptr exception = m_exception;
+      m_exception = nullptr;
+      rethrow_exception(exception);
+    }
+    default: return 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool CodeNatif::traduire() {
+  // Sortie, puis une sortie par code d'état d'erreur : toutes sont avant le code qui y saute
+  m_sortie = m_octets.size();
+  octets({0x41, 0x5C, 0x5D, 0x5B, 0xC3}); // pop r12 ; pop rbp ; pop rbx ; ret
+  for (int32_t etat = DIVISION_PAR_ZERO; etat < EXCEPTION; etat++) {
+    m_erreurs[etat] = m_octets.size();
+    octets({0xB8}); // mov eax, etat
+    mot(etat);
+    allerA({0xE9}, m_sortie);
+  }
+  // Point d'entrée : rbx = registres, rbp = bits "défini" du cadre, r12 = contexte (pile alignée sur 16)
+  m_entree = m_octets.size();
+  octets({0x53, 0x55, 0x41, 0x54, 0x48, 0x89, 0xFB, 0x48, 0x89, 0xF5, 0x49, 0x89, 0xD4});
+  const vector<Instruction> & code = m_machine.getCode();
+  vector<size_t> positions(code.size());
+  for (size_t k = 0; k < code.size(); k++) {
+    const Instruction & instruction = code[k];
+    positions[k] = m_octets.size();
+    switch (instruction.operation) {
+      case OP_CHARGER:
+        registre({0xC7}, 0, instruction.a); // mov dword [a], b
+        mot(instruction.b);
+        break;
+      case OP_COPIER:
+        registre({0x8B}, EAX, instruction.b);
+        registre({0x89}, EAX, instruction.a);
+        break;
+#define X(nom) \
+      case OP_##nom: \
+      case OP_##nom##_I: \
+        registre({0x8B}, EAX, instruction.b); \
+        secondOperande(instruction.operation == OP_##nom##_I, instruction.c); \
+        calculer(S_##nom); \
+        registre({0x89}, EAX, instruction.a); \
+        break;
+        OPERATEURS_BINAIRES(X)
+#undef X
+      case OP_NON:
+        registre({0x8B}, EAX, instruction.b);
+        octets({0x85, 0xC0, 0x0F, 0x94, 0xC0, 0x0F, 0xB6, 0xC0}); // test eax, eax ; sete al ; movzx eax, al
+        registre({0x89}, EAX, instruction.a);
+        break;
+      case OP_OPPOSE:
+        registre({0x8B}, EAX, instruction.b);
+        octets({0xF7, 0xD8}); // neg eax
+        registre({0x89}, EAX, instruction.a);
+        break;
+      case OP_SAUT:
+        saut({0xE9}, instruction.c);
+        break;
+      case OP_SAUTSI:
+      case OP_SAUTSINON:
+        registre({0x8B}, EAX, instruction.b);
+        octets({0x85, 0xC0});
+        saut({0x0F, (uint8_t) (instruction.operation == OP_SAUTSI ? 0x85 : 0x84)}, instruction.c); // jnz / jz
+        break;
+#define X(nom) \
+      case OP_SI_##nom: \
+      case OP_SI_##nom##_I: \
+        registre({0x8B}, EAX, instruction.a); \
+        secondOperande(instruction.operation == OP_SI_##nom##_I, instruction.b); \
+        octets({0x39, 0xC8}); \
+        saut({0x0F, (uint8_t) (0x80 | condition(S_##nom))}, instruction.c); \
+        break;
+        COMPARAISONS(X)
+#undef X
+#define X(nom) \
+      case OP_BOUCLER_##nom: \
+        registre({0x8B}, EAX, instruction.a); \
+        octets({0x05}); /* add eax, pas */ \
+        mot(instruction.b); \
+        registre({0x89}, EAX, instruction.a); \
+        octets({0x3D}); /* cmp eax, limite */ \
+        mot(instruction.c); \
+        saut({0x0F, (uint8_t) (0x80 | condition(S_##nom))}, instruction.d); \
+        break;
+        COMPARAISONS(X)
+#undef X
+      case OP_VERIFIER:
+        bit(4, instruction.a);
+        allerA({0x0F, 0x83}, m_erreurs[INDEFINI]); // jnc
+        break;
+      case OP_DEFINIR:
+        bit(5, instruction.a);
+        break;
+      case OP_ECRIRE:
+        appeler(ecrire, instruction.a, 0, true);
+        break;
+      case OP_ECRIRECHAINE:
+        appeler(ecrireChaine, instruction.a, 0);
+        break;
+      case OP_LIRE:
+        appeler(lire, instruction.a, 0);
+        break;
+      case OP_DELEGUER:
+        appeler(deleguer, instruction.a, instruction.b);
+        break;
+      case OP_DELEGUERAFFECTATION:
+        appeler(deleguerAffectation, instruction.a, instruction.b);
+        break;
+      case OP_INTERDIT:
+        allerA({0xE9}, m_erreurs[INTERDIT]);
+        break;
+      case OP_FIN:
+        octets({0x31, 0xC0}); // xor eax, eax : TERMINE
+        allerA({0xE9}, m_sortie);
+        break;
+      default: // instruction inconnue : le programme restera exécuté par la machine virtuelle
+        return false;
+    }
+  }
+  for (const pair<size_t, int32_t> & s : m_sauts) {
+    if (s.second < 0 || (size_t) s.second >= code.size()) return false;
+    int32_t deplacement = (int32_t) (positions[s.second] - (s.first + 4));
+    memcpy(&m_octets[s.first], &deplacement, 4);
+  }
+  return true;
+}
+
+bool CodeNatif::installer() {
+  size_t page = sysconf(_SC_PAGESIZE);
+  size_t taille = (m_octets.size() + page - 1) / page * page;
+  void * zone = mmap(nullptr, taille, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (zone == MAP_FAILED) return false;
+  memcpy(zone, m_octets.data(), m_octets.size());
+  if (mprotect(zone, taille, PROT_READ | PROT_EXEC) != 0) { // jamais inscriptible et exécutable à la fois
+    munmap(zone, taille);
+    return false;
+  }
+  m_zone = zone;
+  m_tailleZone = taille;
+  m_fonction = (Fonction) ((uint8_t *) zone + m_entree);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CodeNatif::octets(initializer_list<uint8_t> code) {
+  m_octets.insert(m_octets.end(), code);
+}
+
+void CodeNatif::mot(int32_t valeur) {
+  uint8_t octets[4];
+  memcpy(octets, &valeur, 4);
+  m_octets.insert(m_octets.end(), octets, octets + 4);
+}
+
+void CodeNatif::registre(initializer_list<uint8_t> code, uint8_t reg, int32_t numero) {
+  octets(code);
+  octets({(uint8_t) (0x80 | reg << 3 | 3)}); // [rbx + déplacement de 32 bits]
+  mot(numero * 4);
+}
+
+void CodeNatif::bit(uint8_t extension, uint32_t variable) {
+  octets({0x48, 0x0F, 0xBA, (uint8_t) (0x80 | extension << 3 | 5)}); // bt(s) qword [rbp + déplacement], bit
+  mot((variable >> 6) * 8);
+  octets({(uint8_t) (variable & 63)});
+}
+
+void CodeNatif::saut(initializer_list<uint8_t> code, int32_t cible) {
+  octets(code);
+  m_sauts.push_back({m_octets.size(), cible});
+  mot(0);
+}
+
+void CodeNatif::allerA(initializer_list<uint8_t> code, size_t position) {
+  octets(code);
+  mot((int32_t) (position - (m_octets.size() + 4)));
+}
+
+void CodeNatif::secondOperande(bool immediat, int32_t operande) {
+  if (immediat) {
+    octets({0xB9}); // mov ecx, constante
+    mot(operande);
+  } else {
+    registre({0x8B}, ECX, operande);
+  }
+}
+
+void CodeNatif::calculer(CodeSymbole operateur) {
+  switch (operateur) {
+    case S_PLUS: octets({0x01, 0xC8}); break; // add eax, ecx (modulo 2^32, comme calculer)
+    case S_MOINS: octets({0x29, 0xC8}); break; // sub eax, ecx
+    case S_MULTIPLIE: octets({0x0F, 0xAF, 0xC1}); break; // imul eax, ecx
+    case S_DIVISE:
+      octets({0x85, 0xC9}); // test ecx, ecx
+      allerA({0x0F, 0x84}, m_erreurs[DIVISION_PAR_ZERO]);
+      // x / -1 = -x modulo 2^32 : idiv provoquerait une erreur du processeur pour le plus petit entier
+      octets({0x83, 0xF9, 0xFF, 0x75, 0x04, 0xF7, 0xD8, 0xEB, 0x03}); // cmp ecx, -1 ; jne idiv ; neg eax ; jmp fin
+      octets({0x99, 0xF7, 0xF9}); // cdq ; idiv ecx
+      break;
+    default: // comparaison
+      octets({0x39, 0xC8, 0x0F, (uint8_t) (0x90 | condition(operateur)), 0xC0, 0x0F, 0xB6, 0xC0}); // cmp ; setcc ; movzx
+      break;
+  }
+}
+
+void CodeNatif::appeler(int32_t (*fonction)(CodeNatif *, int32_t, int32_t), int32_t a, int32_t b, bool valeurDeA) {
+  octets({0x4C, 0x89, 0xE7}); // mov rdi, r12
+  if (valeurDeA) {
+    registre({0x8B}, ESI, a);
+  } else {
+    octets({0xBE}); // mov esi, a
+    mot(a);
+  }
+  octets({0xBA}); // mov edx, b
+  mot(b);
+  uint64_t adresse = (uint64_t) fonction;
+  octets({0x48, 0xB8}); // mov rax, adresse
+  uint8_t octetsAdresse[8];
+  memcpy(octetsAdresse, &adresse, 8);
+  m_octets.insert(m_octets.end(), octetsAdresse, octetsAdresse + 8);
+  octets({0xFF, 0xD0, 0x85, 0xC0}); // call rax ; test eax, eax
+  allerA({0x0F, 0x85}, m_sortie); // le code d'état de la fonction est déjà dans eax
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int32_t CodeNatif::ecrire(CodeNatif *, int32_t valeur, int32_t) {
+  cout << valeur;
+  return 0;
+}
+
+int32_t CodeNatif::ecrireChaine(CodeNatif * contexte, int32_t chaine, int32_t) {
+  cout << contexte->m_machine.getPlat().getChaine(chaine);
+  return 0;
+}
+
+int32_t CodeNatif::lire(CodeNatif * contexte, int32_t registre, int32_t) {
+  int valeur;
+  cin >> valeur;
+  contexte->m_registres[registre] = valeur;
+  return 0;
+}
+
+int32_t CodeNatif::deleguer(CodeNatif * contexte, int32_t registre, int32_t externe) {
+  // le noeud externe travaille sur le cadre : on y range les variables avant, et on les recharge après
+  int * valeurs = contexte->m_machine.getPlat().getCadre().getValeurs();
+  int32_t * r = contexte->m_registres.data();
+  size_t tailleVariables = contexte->m_machine.getNbVariables() * sizeof (int32_t);
+  memcpy(valeurs, r, tailleVariables);
+  int32_t valeur;
+  try {
+    valeur = contexte->m_machine.getPlat().getExterne(externe)->executer();
+  } catch (...) { // une exception ne peut pas traverser le code natif : on la relancera au retour
+    contexte->m_exception = current_exception();
+    return EXCEPTION;
+  }
+  memcpy(r, valeurs, tailleVariables);
+  r[registre] = valeur;
+  return 0;
+}
+
+int32_t CodeNatif::deleguerAffectation(CodeNatif * contexte, int32_t externe, int32_t registre) {
+  int * valeurs = contexte->m_machine.getPlat().getCadre().getValeurs();
+  int32_t * r = contexte->m_registres.data();
+  size_t tailleVariables = contexte->m_machine.getNbVariables() * sizeof (int32_t);
+  memcpy(valeurs, r, tailleVariables);
+  try {
+    contexte->m_machine.getPlat().getExterne(externe)->affecter(r[registre]);
+  } catch (...) {
+    contexte->m_exception = current_exception();
+    return EXCEPTION;
+  }
+  memcpy(r, valeurs, tailleVariables);
+  return 0;
+}
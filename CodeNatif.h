@@ -0,0 +1,77 @@
+#ifndef CODENATIF_H
+#define CODENATIF_H
+
+#include <cstdint>
+#include <exception>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+using namespace std;
+
+#include "MachineVirtuelle.h"
+
+// CodeNatif traduit le programme de la machine virtuelle en code machine x86-64, écrit dans une zone
+// mémoire exécutable (mmap), puis l'exécute directement : chaque instruction de la machine devient
+// quelques instructions du processeur, les registres de la machine restant dans un tableau d'entiers.
+// Les erreurs (division par zéro, variable indéfinie, valeur d'une chaîne) font sortir le code natif
+// avec un code d'état, traduit en exception au retour : aucune exception ne traverse le code natif.
+// ecrire, lire et les noeuds externes sont exécutés par des fonctions de l'interpréteur que le code
+// natif appelle. Sur un autre processeur, ou si la zone exécutable ne peut être obtenue, l'exécution
+// est confiée à la machine virtuelle.
+
+class CodeNatif {
+public:
+    CodeNatif(MachineVirtuelle & machine); // Traduit le programme compilé de machine en code natif
+    ~CodeNatif(); // Libère la zone exécutable
+    int executer(); // Exécute le code natif (ou la machine virtuelle s'il n'a pas pu être produit)
+
+    inline bool estDisponible() const {
+        return m_fonction != nullptr;
+    } // indique si le programme a été traduit en code natif
+
+private:
+    CodeNatif(const CodeNatif &) = delete;
+    CodeNatif & operator=(const CodeNatif &) = delete;
+
+    // Code d'état renvoyé par le code natif (et par les fonctions qu'il appelle ; 0 : on continue)
+    enum Etat : int32_t { TERMINE, DIVISION_PAR_ZERO, INDEFINI, INTERDIT, EXCEPTION };
+    typedef int32_t (*Fonction)(int32_t * registres, uint64_t * definis, CodeNatif * contexte);
+
+    MachineVirtuelle & m_machine; // La machine dont on traduit le programme (et à qui on délègue au besoin)
+    vector<uint8_t> m_octets; // Le code machine, pendant sa production
+    size_t m_sortie; // Position de la sortie du code natif (le code d'état est dans eax)
+    size_t m_erreurs[EXCEPTION]; // Position du code qui sort avec chaque code d'état d'erreur
+    size_t m_entree; // Position du point d'entrée
+    vector<pair<size_t, int32_t>> m_sauts; // Déplacements à corriger : position, instruction de la machine visée
+    void * m_zone; // La zone exécutable qui contient le code machine
+    size_t m_tailleZone; // Taille de la zone
+    Fonction m_fonction; // Point d'entrée du code natif, nullptr s'il n'a pas été produit
+    vector<int32_t> m_registres; // Les registres de la machine pendant l'exécution
+    exception_ptr m_exception; // L'exception levée par un noeud externe, relancée au retour du code natif
+
+    bool traduire(); // Produit le code machine de tout le programme dans m_octets (faux si impossible)
+    bool installer(); // Copie m_octets dans une zone exécutable
+
+    // Production du code machine
+    void octets(initializer_list<uint8_t> code); // Ajoute des octets
+    void mot(int32_t valeur); // Ajoute un entier de 32 bits
+    void registre(initializer_list<uint8_t> code, uint8_t reg, int32_t numero);
+    // Instruction code dont l'opérande mémoire est le registre numero de la machine, et l'autre reg
+    void bit(uint8_t extension, uint32_t variable); // bt (extension 4) ou bts (5) sur le bit "défini" de variable
+    void saut(initializer_list<uint8_t> code, int32_t cible); // Saut vers l'instruction cible de la machine
+    void allerA(initializer_list<uint8_t> code, size_t position); // Saut vers une position déjà produite
+    void secondOperande(bool immediat, int32_t operande);
+    // Charge dans ecx le registre operande de la machine, ou la constante operande si immediat
+    void calculer(CodeSymbole operateur); // eax = eax operateur ecx
+    void appeler(int32_t (*fonction)(CodeNatif *, int32_t, int32_t), int32_t a, int32_t b, bool valeurDeA = false);
+    // Appelle fonction(this, a, b) (a est remplacé par la valeur du registre a si valeurDeA) et sort si elle échoue
+
+    // Fonctions de l'interpréteur appelées par le code natif
+    static int32_t ecrire(CodeNatif * contexte, int32_t valeur, int32_t);
+    static int32_t ecrireChaine(CodeNatif * contexte, int32_t chaine, int32_t);
+    static int32_t lire(CodeNatif * contexte, int32_t registre, int32_t);
+    static int32_t deleguer(CodeNatif * contexte, int32_t registre, int32_t externe);
+    static int32_t deleguerAffectation(CodeNatif * contexte, int32_t externe, int32_t registre);
+};
+
+#endif /* CODENATIF_H */
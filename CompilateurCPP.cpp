@@ -0,0 +1,345 @@
+#include "CompilateurCPP.h"
+#include "Hachage.h"
+#include "Operations.h"
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+using namespace std;
+
+// Version de la traduction : à changer quand le code produit change, pour invalider le cache
+static const char * const VERSION_TRADUCTION = "4";
+
+// Début de l'unité de traduction : ce dont le code traduit a besoin pour se comporter comme l'interpréteur
+static const char * const PROLOGUE = R"(#include <iostream>
+using namespace std;
+
+struct Erreur {
+    const char * message;
+}; // Même message que l'exception de l'interpréteur
+
+struct Variable {
+    int valeur = 0;
+    bool defini = false;
+
+    operator int() const {
+        if (!defini) throw Erreur{"Valeur Indéfinie"};
+        return valeur;
+    }
+
+    Variable & operator=(int v) {
+        valeur = v;
+        defini = true;
+        return *this;
+    }
+
+    Variable & operator=(const Variable & v) {
+        return *this = (int) v;
+    }
+};
+
+static ostream & operator<<(ostream & sortie, const Variable & v) {
+    return sortie << (int) v;
+}
+
+static istream & operator>>(istream & entree, Variable & v) {
+    int valeur;
+    entree >> valeur;
+    v = valeur;
+    return entree;
+}
+
+static int diviser(int og, int od) {
+    if (od == 0) throw Erreur{"Division par 0"};
+    return od == -1 ? (int) (0u - (unsigned int) og) : og / od;
+}
+
+static int interdit() {
+    throw Erreur{"Operation Interdite sur un noeud"};
+}
+
+)";
+
+////////////////////////////////////////////////////////////////////////////////
+
+CompilateurCPP::CompilateurCPP() : m_repertoire(), m_compilateur() {
+  const char * cache = getenv("XDG_CACHE_HOME");
+  const char * maison = getenv("HOME");
+  if (cache != nullptr && cache[0] != '\0') m_repertoire = cache;
+  else if (maison != nullptr && maison[0] != '\0') m_repertoire = string(maison) + "/.cache";
+  else m_repertoire = "/tmp";
+  mkdir(m_repertoire.c_str(), 0755); // sans effet s'il existe déjà
+  m_repertoire += "/projet-c-";
+  mkdir(m_repertoire.c_str(), 0755);
+  const char * compilateur = getenv("CXX");
+  m_compilateur = (compilateur != nullptr && compilateur[0] != '\0') ? compilateur : "c++";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+string CompilateurCPP::cle(const Source & source) const {
+  // 64 bits : deux hachages de 32 bits de graines différentes
+  string texte(source.getDebut(), source.getTaille());
+  texte.append(1, '\0').append(m_compilateur).append(1, '\0').append(VERSION_TRADUCTION);
+  ostringstream cle;
+  cle << hex << setfill('0') << setw(8) << hacher(texte, 0) << setw(8) << hacher(texte, 0x9e3779b9u);
+  return cle.str();
+}
+
+string CompilateurCPP::getExecutable(const string & cle) const {
+  return m_repertoire + "/" + cle;
+}
+
+bool CompilateurCPP::estEnCache(const string & cle) const {
+  return access(getExecutable(cle).c_str(), X_OK) == 0;
+}
+
+static bool executerCommande(const vector<string> & arguments) {
+  // Lance la commande sans passer par le shell (aucun caractère des chemins n'est interprété), sa sortie
+  //  d'erreur vers /dev/null, et attend qu'elle se termine ; vrai si elle a réussi
+  vector<char *> argv;
+  for (const string & argument : arguments) argv.push_back(const_cast<char *> (argument.c_str()));
+  argv.push_back(nullptr);
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addopen(&actions, 2, "/dev/null", O_WRONLY, 0);
+  pid_t pid;
+  int etat = 0;
+  bool lancee = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ) == 0;
+  posix_spawn_file_actions_destroy(&actions);
+  if (!lancee || waitpid(pid, &etat, 0) != pid) return false;
+  return WIFEXITED(etat) && WEXITSTATUS(etat) == 0;
+}
+
+bool CompilateurCPP::compiler(const ArbrePlat & plat, const string & cle) {
+  string executable = getExecutable(cle);
+  string temporaire = executable + "." + to_string(getpid()); // renommé une fois complet : jamais d'exécutable à moitié écrit
+  string source = temporaire + ".XXXXXX.cpp"; // nom unique : deux exécutions du même source ne se marchent pas dessus
+  int descripteur = mkstemps(&source[0], 4);
+  if (descripteur < 0) return false;
+  close(descripteur);
+  bool traduit;
+  {
+    ofstream fichier(source);
+    traduit = traduireProgramme(plat, fichier) && fichier.flush();
+  }
+  vector<string> commande;
+  istringstream mots(m_compilateur); // CXX peut contenir des options, ou un lanceur ("ccache g++")
+  for (string mot; mots >> mot;) commande.push_back(mot);
+  for (const char * option : {"-O2", "-fwrapv", "-w", "-o"}) commande.push_back(option);
+  commande.push_back(temporaire);
+  commande.push_back(source);
+  bool compile = traduit && executerCommande(commande);
+  remove(source.c_str()); // le source ne sert plus : seul l'exécutable est gardé
+  if (!compile || rename(temporaire.c_str(), executable.c_str()) != 0) {
+    remove(temporaire.c_str());
+    return false;
+  }
+  return true;
+}
+
+void CompilateurCPP::lancer(const string & cle) const {
+  string executable = getExecutable(cle);
+  cout.flush();
+  execl(executable.c_str(), executable.c_str(), (char *) nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool CompilateurCPP::traduireProgramme(const ArbrePlat & plat, ostream & sortie) {
+  ostringstream corps; // on ne sait qu'à la fin si tout se traduit
+  if (!traduire(plat, plat.getRacine(), corps, 2)) return false;
+  sortie << PROLOGUE;
+  const Cadre & cadre = plat.getCadre();
+  for (unsigned int i = 0; i < cadre.getTaille(); i++) sortie << "static Variable v_" << cadre.getNom(i) << ";" << endl;
+  sortie << endl << "int main() {" << endl
+          << "    try {" << endl
+          << corps.str()
+          << "    } catch (const Erreur & erreur) {" << endl
+          << "        cout << erreur.message << endl;" << endl
+          << "    }" << endl
+          << "    return 0;" << endl
+          << "}" << endl;
+  return true;
+}
+
+static void ecrireChaine(ostream & cout, const string & texte) {
+  cout << '"';
+  for (char c : texte) {
+    if (c == '"' || c == '\\') cout << '\\' << c;
+    else if (c == '\n') cout << "\\n";
+    else cout << c;
+  }
+  cout << '"';
+}
+
+bool CompilateurCPP::traduire(const ArbrePlat & plat, uint32_t i, ostream & cout, unsigned int indentation) {
+  // Même texte que ArbrePlat::traduitEnCPP, sauf les variables (préfixées : un nom du langage peut être un
+  // mot clé du C++) et la division (vérifiée)
+  const NoeudPlat & n = plat.getNoeud(i);
+  bool ok = true;
+  switch (n.genre) {
+    case P_SEQUENCE:
+      for (uint32_t j = 0; j < n.b; j++) {
+        GenrePlat genre = plat.getNoeud(plat.getFils(n, j)).genre;
+        ok &= traduire(plat, plat.getFils(n, j), cout, indentation);
+        if (genre == P_AFFECTATION || genre == P_ECRIRE || genre == P_LIRE) cout << ";";
+        cout << endl;
+      }
+      break;
+    case P_AFFECTATION:
+      cout << setw(4 * indentation) << "";
+      ok = plat.getNoeud(n.a).genre == P_VARIABLE && traduire(plat, n.a, cout, 0);
+      cout << " = ";
+      ok &= traduire(plat, n.b, cout, 0);
+      break;
+    case P_OPERATEUR: {
+      // Les opérandes d'un opérateur (ou les arguments d'une fonction) du C++ sont évalués dans un ordre
+      //  quelconque : si les deux peuvent échouer, le gauche est d'abord rangé dans g, pour que l'erreur
+      //  signalée soit celle de l'interpréteur (x / (1 / k) : x indéfinie, et non division par 0)
+      CodeSymbole operateur = (CodeSymbole) n.code;
+      bool ordonne = plat.getNoeud(n.a).genre != P_ENTIER && plat.getNoeud(n.b).genre != P_ENTIER;
+      if (ordonne) {
+        cout << "[&] { int g = ";
+        ok = traduire(plat, n.a, cout, 0);
+        if (operateur == S_DIVISE) cout << "; return diviser(g, ";
+        else cout << "; return (g " << operateurCPP(operateur) << " ";
+        ok &= traduire(plat, n.b, cout, 0);
+        cout << "); }()";
+      } else if (operateur == S_DIVISE) {
+        cout << "diviser(";
+        ok = traduire(plat, n.a, cout, 0);
+        cout << ", ";
+        ok &= traduire(plat, n.b, cout, 0);
+        cout << ")";
+      } else {
+        cout << "(";
+        ok = traduire(plat, n.a, cout, 0);
+        cout << " " << operateurCPP(operateur) << " ";
+        ok &= traduire(plat, n.b, cout, 0);
+        cout << ")";
+      }
+      break;
+    }
+    case P_LOGIQUE: // && et || n'évaluent l'opérande droit qu'au besoin, comme l'interpréteur
+      cout << "(";
+      ok = traduire(plat, n.a, cout, 0);
+      cout << " " << operateurCPP((CodeSymbole) n.code) << " ";
+      ok &= traduire(plat, n.b, cout, 0);
+      cout << ")";
+      break;
+    case P_UNAIRE:
+      cout << "(" << operateurCPP((CodeSymbole) n.code);
+      ok = traduire(plat, n.a, cout, 0);
+      cout << ")";
+      break;
+    case P_SIRICHE: {
+      vector<uint32_t> cles;
+      uint32_t variable = plat.selon(n, cles);
+      if (variable != ArbrePlat::AUCUN) { // un switch, comme ArbrePlat::traduitEnCPP
+        cout << setw(4 * indentation) << "" << "switch (";
+        ok = traduire(plat, variable, cout, 0);
+        cout << ") {" << endl;
+        for (uint32_t j = 0; j < cles.size(); j++) {
+          cout << setw(4 * (indentation + 1)) << "" << "case ";
+          ok &= traduire(plat, cles[j], cout, 0);
+          cout << ": {" << endl;
+          ok &= traduire(plat, plat.getFils(n, 2 * j + 1), cout, indentation + 2);
+          cout << setw(4 * (indentation + 1)) << "" << "} break;" << endl;
+        }
+        if (n.b % 2) {
+          cout << setw(4 * (indentation + 1)) << "" << "default: {" << endl;
+          ok &= traduire(plat, plat.getFils(n, n.b - 1), cout, indentation + 2);
+          cout << setw(4 * (indentation + 1)) << "" << "}" << endl;
+        }
+        cout << setw(4 * indentation) << "" << "}";
+        break;
+      }
+      uint32_t j = 0;
+      cout << setw(4 * indentation) << "" << "if (";
+      ok = traduire(plat, plat.getFils(n, j++), cout, 0);
+      cout << ") {" << endl;
+      ok &= traduire(plat, plat.getFils(n, j++), cout, indentation + 1);
+      cout << setw(4 * indentation) << "" << "}";
+      while (j + 2 <= n.b) {
+        cout << " else if (";
+        ok &= traduire(plat, plat.getFils(n, j++), cout, 0);
+        cout << ") {" << endl;
+        ok &= traduire(plat, plat.getFils(n, j++), cout, indentation + 1);
+        cout << setw(4 * indentation) << "" << "}";
+      }
+      if (n.b % 2) {
+        cout << " else {" << endl;
+        ok &= traduire(plat, plat.getFils(n, n.b - 1), cout, indentation + 1);
+        cout << setw(4 * indentation) << "" << "}";
+      }
+      break;
+    }
+    case P_TANTQUE:
+      cout << setw(4 * indentation) << "" << "while (";
+      ok = traduire(plat, n.a, cout, 0);
+      cout << ") {" << endl;
+      ok &= traduire(plat, n.b, cout, indentation + 1);
+      cout << setw(4 * indentation) << "" << "}";
+      break;
+    case P_REPETER:
+      cout << setw(4 * indentation) << "" << "do {" << endl;
+      ok = traduire(plat, n.a, cout, indentation + 1);
+      cout << setw(4 * indentation) << "" << "} while (!";
+      ok &= traduire(plat, n.b, cout, 0);
+      cout << ");";
+      break;
+    case P_POUR:
+      cout << setw(4 * indentation) << "" << "for (";
+      if (plat.getFils(n, 0) != ArbrePlat::AUCUN) ok = traduire(plat, plat.getFils(n, 0), cout, 0);
+      cout << "; ";
+      ok &= traduire(plat, plat.getFils(n, 1), cout, 0);
+      cout << "; ";
+      if (plat.getFils(n, 2) != ArbrePlat::AUCUN) ok &= traduire(plat, plat.getFils(n, 2), cout, 0);
+      cout << ") {" << endl;
+      ok &= traduire(plat, plat.getFils(n, 3), cout, indentation + 1);
+      cout << setw(4 * indentation) << "" << "}";
+      break;
+    case P_ECRIRE:
+      cout << setw(4 * indentation) << "" << "cout";
+      for (uint32_t j = 0; j < n.b; j++) {
+        const NoeudPlat & parametre = plat.getNoeud(plat.getFils(n, j));
+        cout << " << ";
+        if (parametre.genre == P_CHAINE) ecrireChaine(cout, plat.getChaine(parametre.a));
+        else ok &= traduire(plat, plat.getFils(n, j), cout, 0);
+      }
+      break;
+    case P_LIRE:
+      cout << setw(4 * indentation) << "" << "cin";
+      for (uint32_t j = 0; j < n.b; j++) {
+        cout << " >> ";
+        ok &= plat.getNoeud(plat.getFils(n, j)).genre == P_VARIABLE && traduire(plat, plat.getFils(n, j), cout, 0);
+      }
+      break;
+    case P_VARIABLE:
+      cout << "v_" << plat.getCadre().getNom(n.a);
+      break;
+    case P_ENTIER:
+      if ((int) n.a == INT32_MIN) cout << "(-2147483647 - 1)"; // pas de littéral pour le plus petit entier
+      else if ((int) n.a < 0) cout << "(" << (int) n.a << ")";
+      else cout << (int) n.a;
+      break;
+    case P_CHAINE: // une chaîne n'a pas de valeur entière
+      cout << "interdit()";
+      break;
+    case P_EXTERNE: { // noeud inconnu de l'arbre aplati : seule une boucle calculée se traduit (par sa boucle)
+      Noeud * externe = plat.getExterne(n.a);
+      if (externe->getGenre() != Genre::BOUCLE_CALCULEE) return false;
+      NoeudBoucleCalculee * calculee = (NoeudBoucleCalculee *) externe;
+      ArbrePlat boucle(*calculee->getBoucle(), plat.getCadre());
+      return traduire(boucle, boucle.getRacine(), cout, indentation);
+    }
+  }
+  return ok;
+}
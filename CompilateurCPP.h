@@ -0,0 +1,42 @@
+#ifndef COMPILATEURCPP_H
+#define COMPILATEURCPP_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+using namespace std;
+
+#include "ArbrePlat.h"
+#include "Source.h"
+
+// CompilateurCPP compile un programme à l'avance : il le traduit en une unité de traduction C++
+// complète (inclusions, variables, main), la fait compiler par le compilateur du système avec
+// optimisation, et range l'exécutable dans un cache, sous une clé calculée à partir du texte source.
+// Les exécutions suivantes du même source lancent directement l'exécutable, sans lecture ni analyse.
+// Le programme produit a la même sémantique que l'interpréteur : variables indéfinies détectées,
+// division par zéro signalée, arithmétique modulo 2^32 (-fwrapv), mêmes messages d'erreur.
+// Le compilateur est celui de la variable d'environnement CXX (c++ par défaut), lancé sans shell ;
+// le cache est dans $XDG_CACHE_HOME/projet-c- (ou ~/.cache/projet-c-, ou /tmp/projet-c-).
+
+class CompilateurCPP {
+public:
+    CompilateurCPP(); // Choisit le répertoire du cache et le compilateur
+
+    string cle(const Source & source) const; // Clé du programme dans le cache (texte, compilateur, version de la traduction)
+    bool estEnCache(const string & cle) const; // indique si l'exécutable du programme de clé cle est dans le cache
+    bool compiler(const ArbrePlat & plat, const string & cle); // Traduit, compile et met en cache ; faux si échec
+    void lancer(const string & cle) const; // Remplace le processus par l'exécutable (ne revient qu'en cas d'échec)
+
+    static bool traduireProgramme(const ArbrePlat & plat, ostream & sortie);
+    // Écrit l'unité de traduction complète ; faux si l'arbre contient un noeud qui ne se traduit pas
+
+private:
+    string m_repertoire; // Répertoire du cache
+    string m_compilateur; // Commande du compilateur C++
+
+    string getExecutable(const string & cle) const; // Chemin de l'exécutable du programme de clé cle
+    static bool traduire(const ArbrePlat & plat, uint32_t i, ostream & cout, unsigned int indentation);
+    // Traduit le noeud i, comme ArbrePlat::traduitEnCPP mais avec la sémantique exacte de l'interpréteur
+};
+
+#endif /* COMPILATEURCPP_H */
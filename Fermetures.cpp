@@ -0,0 +1,425 @@
+#include "Fermetures.h"
+#include "ArbreAbstrait.h"
+#include "Exceptions.h"
+#include "Operations.h"
+#include <iostream>
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+static inline int executer(const Fermeture * f, Cadre & cadre) {
+  return f->code(*f, cadre);
+}
+
+static int appeler(const Fermeture & f, Cadre & cadre) {
+  return f.code(f, cadre);
+} // Condition quelconque d'une structure de contrôle
+
+static inline void executerListe(const Fermeture & f, Cadre & cadre) {
+  for (uint32_t j = 0; j < f.taille; j++) executer(f.liste[j], cadre);
+}
+
+enum Forme { VARIABLE, CONSTANTE, SOUS_EXPRESSION }; // Forme d'un opérande
+
+static Forme forme(const NoeudPlat & n) {
+  if (n.genre == P_VARIABLE) return VARIABLE;
+  if (n.genre == P_ENTIER) return CONSTANTE;
+  return SOUS_EXPRESSION;
+}
+
+// Lecture d'un opérande de chaque forme : valeur est la case ou la constante (Fermeture::a ou b),
+//  fermeture celle de la sous-expression (Fermeture::g ou d)
+
+struct FormeVariable {
+
+  static inline int valeur(int32_t numeroCase, const Fermeture *, Cadre & cadre) {
+    return cadre.getValeur(numeroCase);
+  }
+};
+
+struct FormeConstante {
+
+  static inline int valeur(int32_t constante, const Fermeture *, Cadre &) {
+    return constante;
+  }
+};
+
+struct FormeFermeture {
+
+  static inline int valeur(int32_t, const Fermeture * fermeture, Cadre & cadre) {
+    return executer(fermeture, cadre);
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Fonctions d'exécution des noeuds
+
+static int interdit(const Fermeture &, Cadre &) {
+  throw OperationInterditeException();
+}
+
+static int rien(const Fermeture &, Cadre &) {
+  return 0;
+}
+
+template <CodeSymbole OPERATEUR, class Gauche, class Droit>
+static int operation(const Fermeture & f, Cadre & cadre) {
+  int og = Gauche::valeur(f.a, f.g, cadre); // l'opérande gauche est évalué en premier
+  return calculer(OPERATEUR, og, Droit::valeur(f.b, f.d, cadre));
+}
+
+template <CodeSymbole OPERATEUR, class Gauche, class Droit>
+static int affecterOperation(const Fermeture & f, Cadre & cadre) {
+  cadre.setValeur(f.c, operation<OPERATEUR, Gauche, Droit>(f, cadre));
+  return 0;
+}
+
+template <class Valeur>
+static int affecter(const Fermeture & f, Cadre & cadre) {
+  cadre.setValeur(f.c, Valeur::valeur(f.a, f.g, cadre));
+  return 0;
+}
+
+static int affecterExterne(const Fermeture & f, Cadre & cadre) {
+  f.externe->affecter(executer(f.g, cadre));
+  return 0;
+}
+
+static int affecterInterdit(const Fermeture & f, Cadre & cadre) {
+  executer(f.g, cadre);
+  throw OperationInterditeException();
+}
+
+static int variable(const Fermeture & f, Cadre & cadre) {
+  return cadre.getValeur(f.a);
+}
+
+static int entier(const Fermeture & f, Cadre &) {
+  return f.a;
+}
+
+static int deleguer(const Fermeture & f, Cadre &) {
+  return f.externe->executer();
+}
+
+static int et(const Fermeture & f, Cadre & cadre) { // l'opérande droit n'est évalué qu'au besoin
+  return executer(f.g, cadre) && executer(f.d, cadre);
+}
+
+static int ou(const Fermeture & f, Cadre & cadre) {
+  return executer(f.g, cadre) || executer(f.d, cadre);
+}
+
+static int non(const Fermeture & f, Cadre & cadre) {
+  return !executer(f.g, cadre);
+}
+
+static int oppose(const Fermeture & f, Cadre & cadre) {
+  return calculerUnaire(S_MOINS, executer(f.g, cadre));
+}
+
+static int sequence(const Fermeture & f, Cadre & cadre) {
+  executerListe(f, cadre);
+  return 0;
+}
+
+static int siRiche(const Fermeture & f, Cadre & cadre) { // liste : condition, séquence..., [séquence du sinon]
+  uint32_t j = 0;
+  for (; j + 1 < f.taille; j += 2)
+    if (executer(f.liste[j], cadre)) return executer(f.liste[j + 1], cadre); // première condition vraie
+  if (j < f.taille) executer(f.liste[j], cadre);
+  return 0;
+}
+
+static int ecrireValeur(const Fermeture & f, Cadre & cadre) {
+  cout << executer(f.g, cadre);
+  return 0;
+}
+
+static int ecrireChaine(const Fermeture & f, Cadre &) {
+  cout << *f.texte;
+  return 0;
+}
+
+static int lireCase(const Fermeture & f, Cadre & cadre) {
+  int valeur;
+  cin >> valeur;
+  cadre.setValeur(f.c, valeur);
+  return 0;
+}
+
+static int lireExterne(const Fermeture & f, Cadre &) {
+  int valeur;
+  cin >> valeur;
+  f.externe->affecter(valeur);
+  return 0;
+}
+
+static int lireInterdit(const Fermeture &, Cadre &) {
+  int valeur;
+  cin >> valeur;
+  throw OperationInterditeException();
+}
+
+// Les structures de contrôle, instanciées pour la fonction CONDITION qui évalue leur condition f.g :
+//  une comparaison de variables et de constantes est ainsi évaluée sans appel. f.liste est la séquence,
+//  f.d l'action d'un pour, ou la séquence du sinon d'un si.
+
+template <CodeFermeture CONDITION>
+struct Structures {
+
+  static int tantque(const Fermeture & f, Cadre & cadre) {
+    while (CONDITION(*f.g, cadre)) executerListe(f, cadre);
+    return 0;
+  }
+
+  static int pour(const Fermeture & f, Cadre & cadre) {
+    for (; CONDITION(*f.g, cadre); executer(f.d, cadre)) executerListe(f, cadre);
+    return 0;
+  }
+
+  static int repeter(const Fermeture & f, Cadre & cadre) {
+    do {
+      executerListe(f, cadre);
+    } while (!CONDITION(*f.g, cadre));
+    return 0;
+  }
+
+  static int si(const Fermeture & f, Cadre & cadre) {
+    if (CONDITION(*f.g, cadre)) executerListe(f, cadre);
+    else if (f.d != nullptr) executer(f.d, cadre);
+    return 0;
+  }
+};
+
+enum Structure { TANTQUE, POUR, REPETER, SI };
+
+template <CodeFermeture CONDITION>
+static CodeFermeture structure(Structure genre) {
+  switch (genre) {
+    case TANTQUE: return &Structures<CONDITION>::tantque;
+    case POUR: return &Structures<CONDITION>::pour;
+    case REPETER: return &Structures<CONDITION>::repeter;
+    default: return &Structures<CONDITION>::si;
+  }
+}
+
+static CodeFermeture specialiser(Structure genre, CodeFermeture condition) {
+  // La structure dont la condition est évaluée en ligne si c'est une comparaison connue, par appel sinon
+#define X(nom) \
+  if (condition == &operation<S_##nom, FormeVariable, FormeVariable>) \
+    return structure<&operation<S_##nom, FormeVariable, FormeVariable>>(genre); \
+  if (condition == &operation<S_##nom, FormeVariable, FormeConstante>) \
+    return structure<&operation<S_##nom, FormeVariable, FormeConstante>>(genre); \
+  if (condition == &operation<S_##nom, FormeConstante, FormeVariable>) \
+    return structure<&operation<S_##nom, FormeConstante, FormeVariable>>(genre);
+  COMPARAISONS(X)
+#undef X
+  return structure<&appeler>(genre);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <class Gauche, class Droit>
+static CodeFermeture instancier(CodeSymbole operateur, bool affectation) {
+  switch (operateur) {
+#define X(nom) \
+    case S_##nom: \
+      return affectation ? &affecterOperation<S_##nom, Gauche, Droit> : &operation<S_##nom, Gauche, Droit>;
+      OPERATEURS_BINAIRES(X)
+#undef X
+    default: return &interdit;
+  }
+}
+
+template <class Gauche>
+static CodeFermeture avecDroit(CodeSymbole operateur, Forme droit, bool affectation) {
+  if (droit == VARIABLE) return instancier<Gauche, FormeVariable>(operateur, affectation);
+  if (droit == CONSTANTE) return instancier<Gauche, FormeConstante>(operateur, affectation);
+  return instancier<Gauche, FormeFermeture>(operateur, affectation);
+}
+
+static CodeFermeture choisir(CodeSymbole operateur, Forme gauche, Forme droit, bool affectation) {
+  if (gauche == VARIABLE) return avecDroit<FormeVariable>(operateur, droit, affectation);
+  if (gauche == CONSTANTE) return avecDroit<FormeConstante>(operateur, droit, affectation);
+  return avecDroit<FormeFermeture>(operateur, droit, affectation);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Fermetures::Fermetures(Noeud & racine, Cadre & cadre) : Fermetures(ArbrePlat(racine, cadre)) {
+  // Les fermetures ne gardent rien de l'arbre aplati (les chaînes sont copiées) : il peut disparaître
+}
+
+Fermetures::Fermetures(const ArbrePlat & plat) :
+m_cadre(plat.getCadre()), m_fermetures(), m_listes(), m_textes(), m_programme(nullptr) {
+  m_programme = compiler(plat, plat.getRacine());
+}
+
+Fermeture & Fermetures::nouvelle(CodeFermeture code) {
+  m_fermetures.push_back({code, 0, 0, 0, nullptr, nullptr, nullptr, 0, nullptr, nullptr});
+  return m_fermetures.back();
+}
+
+void Fermetures::lister(Fermeture & f, vector<const Fermeture *> fermetures) {
+  m_listes.push_back(move(fermetures));
+  f.liste = m_listes.back().data();
+  f.taille = m_listes.back().size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const Fermeture * Fermetures::compiler(const ArbrePlat & plat, uint32_t i) {
+  const NoeudPlat & n = plat.getNoeud(i);
+  switch (n.genre) {
+    case P_SEQUENCE: {
+      Fermeture & f = nouvelle(&sequence);
+      lister(f, compilerCorps(plat, i));
+      return &f;
+    }
+    case P_AFFECTATION: {
+      const NoeudPlat & cible = plat.getNoeud(n.a), & valeur = plat.getNoeud(n.b);
+      if (cible.genre == P_VARIABLE && valeur.genre == P_OPERATEUR) // l'opération écrit directement dans la case
+        return compilerOperation(plat, valeur, cible.a);
+      Fermeture & f = nouvelle(nullptr);
+      if (cible.genre == P_VARIABLE) {
+        f.c = cible.a;
+        if (valeur.genre == P_VARIABLE) f.code = &affecter<FormeVariable>, f.a = valeur.a;
+        else if (valeur.genre == P_ENTIER) f.code = &affecter<FormeConstante>, f.a = valeur.a;
+        else f.code = &affecter<FormeFermeture>, f.g = compiler(plat, n.b);
+      } else {
+        f.g = compiler(plat, n.b);
+        f.code = &affecterInterdit;
+        if (cible.genre == P_EXTERNE) f.code = &affecterExterne, f.externe = plat.getExterne(cible.a);
+      }
+      return &f;
+    }
+    case P_OPERATEUR:
+      return compilerOperation(plat, n, -1);
+    case P_LOGIQUE: {
+      Fermeture & f = nouvelle(n.code == S_ET ? &et : &ou);
+      f.g = compiler(plat, n.a);
+      f.d = compiler(plat, n.b);
+      return &f;
+    }
+    case P_UNAIRE: {
+      Fermeture & f = nouvelle(n.code == S_NON ? &non : &oppose);
+      f.g = compiler(plat, n.a);
+      return &f;
+    }
+    case P_SIRICHE: { // fils : condition, séquence, condition, séquence..., [séquence du sinon]
+      if (n.b == 2 || n.b == 3) { // un seul si (et un sinon) : structure spécialisée
+        Fermeture & f = nouvelle(nullptr);
+        f.g = compiler(plat, plat.getFils(n, 0));
+        lister(f, compilerCorps(plat, plat.getFils(n, 1)));
+        if (n.b == 3) f.d = compiler(plat, plat.getFils(n, 2));
+        f.code = specialiser(SI, f.g->code);
+        return &f;
+      }
+      Fermeture & f = nouvelle(&siRiche);
+      vector<const Fermeture *> fils;
+      for (uint32_t j = 0; j < n.b; j++) fils.push_back(compiler(plat, plat.getFils(n, j)));
+      lister(f, fils);
+      return &f;
+    }
+    case P_TANTQUE:
+    case P_REPETER: {
+      uint32_t condition = (n.genre == P_TANTQUE) ? n.a : n.b, corps = (n.genre == P_TANTQUE) ? n.b : n.a;
+      Fermeture & f = nouvelle(nullptr);
+      f.g = compiler(plat, condition);
+      lister(f, compilerCorps(plat, corps));
+      f.code = specialiser(n.genre == P_TANTQUE ? TANTQUE : REPETER, f.g->code);
+      return &f;
+    }
+    case P_POUR: { // l'affectation et l'action sont facultatives : on n'en teste l'absence qu'ici
+      uint32_t initialisation = plat.getFils(n, 0), action = plat.getFils(n, 2);
+      Fermeture & boucle = nouvelle(nullptr);
+      boucle.g = compiler(plat, plat.getFils(n, 1));
+      lister(boucle, compilerCorps(plat, plat.getFils(n, 3)));
+      if (action != ArbrePlat::AUCUN) boucle.d = compiler(plat, action);
+      boucle.code = specialiser(action != ArbrePlat::AUCUN ? POUR : TANTQUE, boucle.g->code);
+      if (initialisation == ArbrePlat::AUCUN) return &boucle;
+      Fermeture & f = nouvelle(&sequence);
+      lister(f, {compiler(plat, initialisation), &boucle});
+      return &f;
+    }
+    case P_ECRIRE: { // le genre de chaque paramètre est décidé une fois pour toutes
+      Fermeture & f = nouvelle(&sequence);
+      vector<const Fermeture *> parametres;
+      for (uint32_t j = 0; j < n.b; j++) {
+        const NoeudPlat & parametre = plat.getNoeud(plat.getFils(n, j));
+        if (parametre.genre == P_CHAINE) {
+          m_textes.push_back(string(plat.getChaine(parametre.a)));
+          Fermeture & ecrire = nouvelle(&ecrireChaine);
+          ecrire.texte = &m_textes.back();
+          parametres.push_back(&ecrire);
+        } else {
+          Fermeture & ecrire = nouvelle(&ecrireValeur);
+          ecrire.g = compiler(plat, plat.getFils(n, j));
+          parametres.push_back(&ecrire);
+        }
+      }
+      lister(f, parametres);
+      return &f;
+    }
+    case P_LIRE: {
+      Fermeture & f = nouvelle(&sequence);
+      vector<const Fermeture *> variables;
+      for (uint32_t j = 0; j < n.b; j++) variables.push_back(compilerLecture(plat, plat.getFils(n, j)));
+      lister(f, variables);
+      return &f;
+    }
+    case P_VARIABLE: {
+      Fermeture & f = nouvelle(&variable);
+      f.a = n.a;
+      return &f;
+    }
+    case P_ENTIER: {
+      Fermeture & f = nouvelle(&entier);
+      f.a = n.a;
+      return &f;
+    }
+    case P_CHAINE: // une chaîne n'a pas de valeur entière
+      return &nouvelle(&interdit);
+    case P_EXTERNE: {
+      Fermeture & f = nouvelle(&deleguer);
+      f.externe = plat.getExterne(n.a);
+      return &f;
+    }
+  }
+  return &nouvelle(&rien);
+}
+
+const Fermeture * Fermetures::compilerOperation(const ArbrePlat & plat, const NoeudPlat & n, int32_t destination) {
+  const NoeudPlat & gauche = plat.getNoeud(n.a), & droit = plat.getNoeud(n.b);
+  Fermeture & f = nouvelle(choisir((CodeSymbole) n.code, forme(gauche), forme(droit), destination >= 0));
+  f.c = destination;
+  if (forme(gauche) == SOUS_EXPRESSION) f.g = compiler(plat, n.a);
+  else f.a = gauche.a;
+  if (forme(droit) == SOUS_EXPRESSION) f.d = compiler(plat, n.b);
+  else f.b = droit.a;
+  return &f;
+}
+
+vector<const Fermeture *> Fermetures::compilerCorps(const ArbrePlat & plat, uint32_t i) {
+  const NoeudPlat & n = plat.getNoeud(i);
+  if (n.genre != P_SEQUENCE) return {compiler(plat, i)};
+  vector<const Fermeture *> instructions;
+  for (uint32_t j = 0; j < n.b; j++) instructions.push_back(compiler(plat, plat.getFils(n, j)));
+  return instructions;
+}
+
+const Fermeture * Fermetures::compilerLecture(const ArbrePlat & plat, uint32_t i) {
+  const NoeudPlat & n = plat.getNoeud(i);
+  if (n.genre == P_VARIABLE) {
+    Fermeture & f = nouvelle(&lireCase);
+    f.c = n.a;
+    return &f;
+  }
+  if (n.genre == P_EXTERNE) {
+    Fermeture & f = nouvelle(&lireExterne);
+    f.externe = plat.getExterne(n.a);
+    return &f;
+  }
+  return &nouvelle(&lireInterdit);
+}
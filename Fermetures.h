@@ -0,0 +1,67 @@
+#ifndef FERMETURES_H
+#define FERMETURES_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "ArbrePlat.h"
+
+class Noeud;
+struct Fermeture;
+
+typedef int (*CodeFermeture)(const Fermeture & f, Cadre & cadre); // Exécute f (et renvoie sa valeur)
+
+struct Fermeture {
+    CodeFermeture code; // La fonction qui exécute le noeud, choisie à la compilation
+    int32_t a, b, c; // Case ou constante des opérandes gauche et droit, case affectée
+    const Fermeture * g, * d; // Fermetures des opérandes (condition, action...) quand ce sont des sous-expressions
+    const Fermeture * const * liste; // Instructions d'une séquence, paramètres d'ecrire ou de lire...
+    uint32_t taille; // ... et leur nombre
+    Noeud * externe; // Le noeud externe délégué
+    const string * texte; // Le texte d'une chaîne à écrire
+}; // Un morceau de programme compilé : un pointeur de fonction et les données qu'elle a capturées
+
+// Fermetures est un moteur d'exécution par compilation en fermetures : l'arbre est parcouru une seule
+// fois, et chaque noeud devient une Fermeture qui a capturé d'avance tout ce dont elle a besoin (case du
+// cadre, constante, fermetures de ses fils, texte d'une chaîne) et un pointeur vers une fonction écrite
+// pour sa forme exacte. L'exécution n'est plus qu'une suite d'appels de ces fonctions, sans typeid,
+// aiguillage, comparaison de chaînes ni function<> (dont chaque appel coûte autant qu'un appel virtuel).
+// Les opérations binaires sont spécialisées par opérateur et par forme d'opérande, comme NoeudOperation,
+// et une affectation de variable fusionne avec l'opération qu'elle range. Les boucles et les si dont la
+// condition est une comparaison de variables et de constantes l'évaluent sans appel, et exécutent
+// directement les instructions de leur séquence.
+
+class Fermetures {
+public:
+    Fermetures(Noeud & racine, Cadre & cadre); // Compile l'arbre de racine racine, dont les variables sont dans cadre
+    Fermetures(const ArbrePlat & plat); // Compile l'arbre aplati plat
+
+    inline int executer() const {
+        return m_programme->code(*m_programme, m_cadre);
+    } // Exécute le programme compilé (remplace getArbre()->executer())
+
+private:
+    Fermetures(const Fermetures &) = delete;
+    Fermetures & operator=(const Fermetures &) = delete;
+
+    Cadre & m_cadre; // Le cadre des variables
+    deque<Fermeture> m_fermetures; // Toutes les fermetures (une deque ne les déplace pas quand elle grandit)
+    deque<vector<const Fermeture *>> m_listes; // Les listes de fermetures (voir Fermeture::liste)
+    deque<string> m_textes; // Les chaînes copiées de l'arbre aplati
+    const Fermeture * m_programme; // La fermeture de la racine
+
+    Fermeture & nouvelle(CodeFermeture code); // Ajoute une fermeture qui sera exécutée par code
+    void lister(Fermeture & f, vector<const Fermeture *> fermetures); // f.liste, f.taille désignent fermetures
+    const Fermeture * compiler(const ArbrePlat & plat, uint32_t i); // Compile le noeud i de plat
+    const Fermeture * compilerOperation(const ArbrePlat & plat, const NoeudPlat & operation, int32_t destination);
+    // Compile une opération binaire ; si destination >= 0, son résultat est rangé dans cette case
+    vector<const Fermeture *> compilerCorps(const ArbrePlat & plat, uint32_t i);
+    // Compile le noeud i, une séquence (ou une instruction), en la liste de ses instructions
+    const Fermeture * compilerLecture(const ArbrePlat & plat, uint32_t i);
+    // Fermeture qui lit un entier et l'affecte à la variable du noeud i de plat
+};
+
+#endif /* FERMETURES_H */
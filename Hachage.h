@@ -0,0 +1,24 @@
+#ifndef HACHAGE_H
+#define HACHAGE_H
+
+#include <cstdint>
+#include <string_view>
+using namespace std;
+
+// Fonction de hachage des chaînes (FNV-1a 32 bits, suivie d'un brassage des bits de poids faible),
+// utilisable à la compilation comme à l'exécution. La graine permet au générateur de la table
+// des mots clés de chercher une fonction sans collision (hachage parfait).
+
+constexpr uint32_t hacher(string_view s, uint32_t graine = 0) {
+    uint32_t h = 2166136261u ^ graine;
+    for (char c : s) {
+        h ^= (unsigned char) c;
+        h *= 16777619u;
+    }
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    return h;
+}
+
+#endif /* HACHAGE_H */
@@ -5,139 +5,184 @@
 using namespace std;
 
 Interpreteur::Interpreteur(ifstream & fichier) :
-m_lecteur(fichier), m_table(), m_arbre(nullptr) {
+m_lecteur(fichier), m_arene(), m_cadre(), m_table(m_arene), m_litteraux(m_arene), m_expressions(m_arene), m_arbre(nullptr) {
+}
+
+Interpreteur::Interpreteur(Source source, unsigned int nbTaches) :
+m_lecteur(move(source), nbTaches), m_arene(), m_cadre(), m_table(m_arene), m_litteraux(m_arene), m_expressions(m_arene),
+m_arbre(nullptr) {
 }
 
 void Interpreteur::analyse() {
+    // on oublie tout ce qu'une analyse précédente a construit, et on repart du début du texte
+    m_arbre = nullptr;
+    m_table.vider();
+    m_litteraux.vider();
+    m_expressions.vider();
+    m_cadre.vider();
+    m_arene.vider();
+    m_lecteur.recommencer();
     m_arbre = programme(); // on lance l'analyse de la première règle
+    if (m_arbre != nullptr) m_arbre = m_arbre->resoudre(m_cadre, m_arene); // puis on attribue une case à chaque variable
+}
+
+void Interpreteur::optimiser(Optimiseur & optimiseur) {
+    if (m_arbre != nullptr) m_arbre = optimiseur.optimiser(m_arbre);
 }
 
-void Interpreteur::tester(const string & symboleAttendu) const throw (SyntaxeException) {
+void Interpreteur::tester(const string & symboleAttendu) const {
     // Teste si le symbole courant est égal au symboleAttendu... Si non, lève une exception
     static char messageWhat[256];
     if (m_lecteur.getSymbole() != symboleAttendu) {
         sprintf(messageWhat,
                 "Ligne %d, Colonne %d - Erreur de syntaxe - Symbole attendu : %s - Symbole trouvé : %s",
                 m_lecteur.getLigne(), m_lecteur.getColonne(),
-                symboleAttendu.c_str(), m_lecteur.getSymbole().getChaine().c_str());
+                symboleAttendu.c_str(), string(m_lecteur.getSymbole().getChaine()).c_str());
         throw SyntaxeException(messageWhat);
     }
 }
 
-void Interpreteur::testerEtAvancer(const string & symboleAttendu) throw (SyntaxeException) {
+void Interpreteur::testerEtAvancer(const string & symboleAttendu) {
     // Teste si le symbole courant est égal au symboleAttendu... Si oui, avance, Sinon, lève une exception
     tester(symboleAttendu);
     m_lecteur.avancer();
 }
 
-void Interpreteur::erreur(const string & message) const throw (SyntaxeException) {
+void Interpreteur::tester(CodeSymbole codeAttendu) const {
+    // Teste si le code du symbole courant est codeAttendu... Si non, lève une exception
+    // (même message que la version chaîne : le nom du code est la chaîne attendue)
+    if (m_lecteur.getSymbole().getCode() != codeAttendu)
+        tester(Symbole::getNom(codeAttendu));
+}
+
+void Interpreteur::testerEtAvancer(CodeSymbole codeAttendu) {
+    // Teste si le code du symbole courant est codeAttendu... Si oui, avance, Sinon, lève une exception
+    tester(codeAttendu);
+    m_lecteur.avancer();
+}
+
+static inline bool estDebutInstruction(CodeSymbole code) {
+    // Vrai si un symbole de ce code peut commencer une instruction
+    // Il faut compléter ce test chaque fois qu'on rajoute une nouvelle instruction
+    switch (code) {
+        case S_VARIABLE: case S_SI: case S_TANTQUE: case S_REPETER:
+        case S_POUR: case S_ECRIRE: case S_LIRE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static inline bool estOperateurBinaire(CodeSymbole code) {
+    // <opBinaire> ::= + | - | *  | / | < | > | <= | >= | == | != | et | ou
+    switch (code) {
+        case S_PLUS: case S_MOINS: case S_MULTIPLIE: case S_DIVISE:
+        case S_INFERIEUR: case S_INFERIEUREGAL: case S_SUPERIEUR: case S_SUPERIEUREGAL:
+        case S_EGAL: case S_DIFFERENT: case S_ET: case S_OU:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void Interpreteur::erreur(const string & message) const {
     // Lève une exception contenant le message et le symbole courant trouvé
     // Utilisé lorsqu'il y a plusieurs symboles attendus possibles...
     static char messageWhat[256];
     sprintf(messageWhat,
             "Ligne %d, Colonne %d - Erreur de syntaxe - %s - Symbole trouvé : %s",
-            m_lecteur.getLigne(), m_lecteur.getColonne(), message.c_str(), m_lecteur.getSymbole().getChaine().c_str());
+            m_lecteur.getLigne(), m_lecteur.getColonne(), message.c_str(), string(m_lecteur.getSymbole().getChaine()).c_str());
     throw SyntaxeException(messageWhat);
 }
 
 Noeud* Interpreteur::programme() {
     // <programme> ::= procedure principale() <seqInst> finproc FIN_FICHIER
-    testerEtAvancer("procedure");
-    testerEtAvancer("principale");
-    testerEtAvancer("(");
-    testerEtAvancer(")");
+    testerEtAvancer(S_PROCEDURE);
+    testerEtAvancer(S_PRINCIPALE);
+    testerEtAvancer(S_PARENTHESEOUVRANTE);
+    testerEtAvancer(S_PARENTHESEFERMANTE);
     Noeud* sequence = seqInst();
-    testerEtAvancer("finproc");
-    tester("<FINDEFICHIER>");
+    testerEtAvancer(S_FINPROC);
+    tester(S_FINDEFICHIER);
     return sequence;
 }
 
 Noeud* Interpreteur::seqInst() {
     // <seqInst> ::= <inst> { <inst> }
-    NoeudSeqInst* sequence = new NoeudSeqInst();
+    NoeudSeqInst* sequence = m_arene.creer<NoeudSeqInst>();
     do {
         sequence->ajoute(inst());
-    } while (m_lecteur.getSymbole() == "<VARIABLE>"
-            || m_lecteur.getSymbole() == "si"
-            || m_lecteur.getSymbole() == "tantque"
-            || m_lecteur.getSymbole() == "repeter"
-            || m_lecteur.getSymbole() == "pour"
-            || m_lecteur.getSymbole() == "ecrire"
-            || m_lecteur.getSymbole() == "lire");
+    } while (estDebutInstruction(m_lecteur.getSymbole().getCode()));
     // Tant que le symbole courant est un début possible d'instruction...
-    // Il faut compléter cette condition chaque fois qu'on rajoute une nouvelle instruction
     return sequence;
 }
 
 Noeud* Interpreteur::inst() {
     // <inst> ::= <affectation>  ; | <instSi>
     try{
-        if (m_lecteur.getSymbole() == "<VARIABLE>") {
-            Noeud *affect = affectation();
-            testerEtAvancer(";");
-            return affect;
-        } else if (m_lecteur.getSymbole() == "si") {
-            return instSiRiche();
-            // Compléter les alternatives chaque fois qu'on rajoute une nouvelle instruction
-        } else if (m_lecteur.getSymbole() == "tantque") {
-            return instTantQue();
-        } else if (m_lecteur.getSymbole() == "repeter") {
-            Noeud *repeter = instRepeter();
-            testerEtAvancer(";");
-            return repeter;  
-        } else if (m_lecteur.getSymbole() == "pour") {
-            return instPour();
-        } else if (m_lecteur.getSymbole() == "ecrire") {
-            Noeud *ecrire = instEcrire();
-            testerEtAvancer(";");
-            return ecrire;
-        } else if (m_lecteur.getSymbole() == "lire") {
-            Noeud *lire= instLire();
-            testerEtAvancer(";");
-            return lire;
-        } else erreur("Instruction incorrecte");
+        switch (m_lecteur.getSymbole().getCode()) {
+            case S_VARIABLE: {
+                Noeud *affect = affectation();
+                testerEtAvancer(S_POINTVIRGULE);
+                return affect;
+            }
+            case S_SI:
+                return instSiRiche();
+                // Compléter les alternatives chaque fois qu'on rajoute une nouvelle instruction
+            case S_TANTQUE:
+                return instTantQue();
+            case S_REPETER: {
+                Noeud *repeter = instRepeter();
+                testerEtAvancer(S_POINTVIRGULE);
+                return repeter;
+            }
+            case S_POUR:
+                return instPour();
+            case S_ECRIRE: {
+                Noeud *ecrire = instEcrire();
+                testerEtAvancer(S_POINTVIRGULE);
+                return ecrire;
+            }
+            case S_LIRE: {
+                Noeud *lire= instLire();
+                testerEtAvancer(S_POINTVIRGULE);
+                return lire;
+            }
+            default:
+                erreur("Instruction incorrecte");
+        }
     }
     catch (exception & e){
         cout << "Exception" <<e.what()<< endl;
         m_arbre = nullptr;
-        while(m_lecteur.getSymbole() != "<VARIABLE>"
-            && m_lecteur.getSymbole() != "si"
-            && m_lecteur.getSymbole() != "tantque"
-            && m_lecteur.getSymbole() != "repeter"
-            && m_lecteur.getSymbole() != "pour"
-            && m_lecteur.getSymbole() != "ecrire"
-            && m_lecteur.getSymbole() != "lire"
-            && m_lecteur.getSymbole() != "<FINDEFICHIER>")
+        while(!estDebutInstruction(m_lecteur.getSymbole().getCode())
+            && m_lecteur.getSymbole().getCode() != S_FINDEFICHIER)
         {
             m_lecteur.avancer();
         }
     }
+    return nullptr; // instruction erronée : rien à ajouter à la séquence
 }
 
 Noeud* Interpreteur::affectation() {
     // <affectation> ::= <variable> = <expression> 
-    tester("<VARIABLE>");
+    tester(S_VARIABLE);
     Noeud* var = m_table.chercheAjoute(m_lecteur.getSymbole()); // La variable est ajoutée à la table eton la mémorise
     m_lecteur.avancer();
-    testerEtAvancer("=");
+    testerEtAvancer(S_AFFECTATION);
     Noeud* exp = expression(); // On mémorise l'expression trouvée
-    return new NoeudAffectation(var, exp); // On renvoie un noeud affectation
+    return m_arene.creer<NoeudAffectation>(var, exp); // On renvoie un noeud affectation
 }
 
 Noeud* Interpreteur::expression() {
     // <expression> ::= <facteur> { <opBinaire> <facteur> }
     //  <opBinaire> ::= + | - | *  | / | < | > | <= | >= | == | != | et | ou
     Noeud* fact = facteur();
-    while (m_lecteur.getSymbole() == "+" || m_lecteur.getSymbole() == "-" ||
-            m_lecteur.getSymbole() == "*" || m_lecteur.getSymbole() == "/" ||
-            m_lecteur.getSymbole() == "<" || m_lecteur.getSymbole() == "<=" ||
-            m_lecteur.getSymbole() == ">" || m_lecteur.getSymbole() == ">=" ||
-            m_lecteur.getSymbole() == "==" || m_lecteur.getSymbole() == "!=" ||
-            m_lecteur.getSymbole() == "et" || m_lecteur.getSymbole() == "ou") {
+    while (estOperateurBinaire(m_lecteur.getSymbole().getCode())) {
         Symbole operateur = m_lecteur.getSymbole(); // On mémorise le symbole de l'opérateur
         m_lecteur.avancer();
         Noeud* factDroit = facteur(); // On mémorise l'opérande droit
-        fact = new NoeudOperateurBinaire(operateur, fact, factDroit); // Et on construuit un noeud opérateur binaire
+        fact = m_expressions.chercheAjoute(operateur, fact, factDroit); // Et on construit (ou retrouve) le noeud de l'opération
     }
     return fact; // On renvoie fact qui pointe sur la racine de l'expression
 }
@@ -145,57 +190,65 @@ Noeud* Interpreteur::expression() {
 Noeud* Interpreteur::facteur() {
     // <facteur> ::= <entier> | <variable> | - <facteur> | non <facteur> | ( <expression> )
     Noeud* fact = nullptr;
-    if (m_lecteur.getSymbole() == "<VARIABLE>" || m_lecteur.getSymbole() == "<ENTIER>") {
-        fact = m_table.chercheAjoute(m_lecteur.getSymbole()); // on ajoute la variable ou l'entier à la table
-        m_lecteur.avancer();
-    } else if (m_lecteur.getSymbole() == "-") { // - <facteur>
-        m_lecteur.avancer();
-        // on représente le moins unaire (- facteur) par une soustraction binaire (0 - facteur)
-        fact = new NoeudOperateurBinaire(Symbole("-"), m_table.chercheAjoute(Symbole("0")), facteur());
-    } else if (m_lecteur.getSymbole() == "non") { // non <facteur>
-        m_lecteur.avancer();
-        // on représente le moins unaire (- facteur) par une soustractin binaire (0 - facteur)
-        fact = new NoeudOperateurBinaire(Symbole("non"), facteur(), nullptr);
-    } else if (m_lecteur.getSymbole() == "(") { // expression parenthésée
-        m_lecteur.avancer();
-        fact = expression();
-        testerEtAvancer(")");
-    } else
-        erreur("Facteur incorrect");
+    switch (m_lecteur.getSymbole().getCode()) {
+        case S_VARIABLE:
+            fact = m_table.chercheAjoute(m_lecteur.getSymbole()); // on ajoute la variable à la table
+            m_lecteur.avancer();
+            break;
+        case S_ENTIER:
+            fact = m_litteraux.chercheAjouteEntier(m_lecteur.getSymbole()); // l'entier est converti une fois pour toutes
+            m_lecteur.avancer();
+            break;
+        case S_MOINS: // - <facteur>
+            m_lecteur.avancer();
+            fact = m_expressions.chercheAjoute(Symbole("-"), facteur());
+            break;
+        case S_NON: // non <facteur>
+            m_lecteur.avancer();
+            fact = m_expressions.chercheAjoute(Symbole("non"), facteur());
+            break;
+        case S_PARENTHESEOUVRANTE: // expression parenthésée
+            m_lecteur.avancer();
+            fact = expression();
+            testerEtAvancer(S_PARENTHESEFERMANTE);
+            break;
+        default:
+            erreur("Facteur incorrect");
+    }
     return fact;
 }
 
 Noeud* Interpreteur::instSi() {
     // <instSi> ::= si ( <expression> ) <seqInst> finsi
-    testerEtAvancer("si");
-    testerEtAvancer("(");
+    testerEtAvancer(S_SI);
+    testerEtAvancer(S_PARENTHESEOUVRANTE);
     Noeud* condition = expression(); // On mémorise la condition
-    testerEtAvancer(")");
+    testerEtAvancer(S_PARENTHESEFERMANTE);
     Noeud* sequence = seqInst(); // On mémorise la séquence d'instruction
-    testerEtAvancer("finsi");
-    return new NoeudInstSi(condition, sequence); // Et on renvoie un noeud Instruction Si
+    testerEtAvancer(S_FINSI);
+    return m_arene.creer<NoeudInstSi>(condition, sequence); // Et on renvoie un noeud Instruction Si
 }
 
 Noeud* Interpreteur::instTantQue() {
     //<tantQue> ::= tantque( <expression> ) <seqInst> fintantque
-    testerEtAvancer("tantque");
-    testerEtAvancer("(");
+    testerEtAvancer(S_TANTQUE);
+    testerEtAvancer(S_PARENTHESEOUVRANTE);
     Noeud* condition = expression(); // On mémorise la condition
-    testerEtAvancer(")");
+    testerEtAvancer(S_PARENTHESEFERMANTE);
     Noeud* sequence = seqInst(); // On mémorise la séquence d'instruction
-    testerEtAvancer("fintantque");
-    return new NoeudInstTantQue(condition, sequence); // Et on renvoie un noeud Instruction TantQue
+    testerEtAvancer(S_FINTANTQUE);
+    return m_arene.creer<NoeudInstTantQue>(condition, sequence); // Et on renvoie un noeud Instruction TantQue
 }
 
 Noeud* Interpreteur::instRepeter() {
     //<repeter> ::= repeter <seqInst> jusqua( <expression> )    
-    testerEtAvancer("repeter");
+    testerEtAvancer(S_REPETER);
     Noeud* sequence = seqInst(); // On mémorise la séquence d'instruction
-    testerEtAvancer("jusqua");
-    testerEtAvancer("(");
+    testerEtAvancer(S_JUSQUA);
+    testerEtAvancer(S_PARENTHESEOUVRANTE);
     Noeud* condition = expression(); // On mémorise la condition
-    testerEtAvancer(")");
-    return new NoeudInstRepeter(condition, sequence);
+    testerEtAvancer(S_PARENTHESEFERMANTE);
+    return m_arene.creer<NoeudInstRepeter>(sequence, condition);
 }
 
 Noeud* Interpreteur::instPour() {
@@ -216,94 +269,94 @@ Noeud* Interpreteur::instPour() {
     testerEtAvancer(")");
     Noeud* sequence = seqInst();
     testerEtAvancer("finpour");*/
-    testerEtAvancer("pour");
-    testerEtAvancer("(");
+    testerEtAvancer(S_POUR);
+    testerEtAvancer(S_PARENTHESEOUVRANTE);
     Noeud* affecter = nullptr;
-    if (m_lecteur.getSymbole()=="<VARIABLE>"){
+    if (m_lecteur.getSymbole().getCode() == S_VARIABLE){
         affecter = affectation();
     }    
-    testerEtAvancer(";");
-    tester("<VARIABLE>");
+    testerEtAvancer(S_POINTVIRGULE);
+    tester(S_VARIABLE);
     Noeud* condition = expression();
-    testerEtAvancer(";");
+    testerEtAvancer(S_POINTVIRGULE);
     Noeud* action = nullptr;
-    if (m_lecteur.getSymbole()=="<VARIABLE>"){
+    if (m_lecteur.getSymbole().getCode() == S_VARIABLE){
         action = affectation();
     }
-    testerEtAvancer(")");
+    testerEtAvancer(S_PARENTHESEFERMANTE);
     Noeud* sequence = seqInst();
-    testerEtAvancer("finpour");
-    return new NoeudInstPour(affecter,condition,action,sequence);
+    testerEtAvancer(S_FINPOUR);
+    return m_arene.creer<NoeudInstPour>(affecter,condition,action,sequence);
 
 }
 
 Noeud* Interpreteur::instEcrire() {
     // <instEcrire>::= ecrire (<expression> | <chaine> { , <excpresison> | <chaine> } )
-    testerEtAvancer("ecrire");
-    testerEtAvancer("(");
-    NoeudInstEcrire * chaineEcrire = new NoeudInstEcrire();
+    testerEtAvancer(S_ECRIRE);
+    testerEtAvancer(S_PARENTHESEOUVRANTE);
+    NoeudInstEcrire * chaineEcrire = m_arene.creer<NoeudInstEcrire>();
     Noeud *parametre;
     string chaine;
-    if (m_lecteur.getSymbole() == "<CHAINE>") {
-        parametre = m_table.chercheAjoute(m_lecteur.getSymbole());
+    if (m_lecteur.getSymbole().getCode() == S_CHAINE) {
+        parametre = m_litteraux.chercheAjouteChaine(m_lecteur.getSymbole());
         m_lecteur.avancer();
     } else {
         parametre = expression();
     }
     chaineEcrire->ajoute(parametre);
-    while (m_lecteur.getSymbole() == ",") {
+    while (m_lecteur.getSymbole().getCode() == S_VIRGULE) {
         m_lecteur.avancer();
-        if (m_lecteur.getSymbole() == "<CHAINE>") {
-            parametre = m_table.chercheAjoute(m_lecteur.getSymbole());
+        if (m_lecteur.getSymbole().getCode() == S_CHAINE) {
+            parametre = m_litteraux.chercheAjouteChaine(m_lecteur.getSymbole());
             m_lecteur.avancer();
         } else {
             parametre = expression();
         }
         chaineEcrire->ajoute(parametre);
     }
-    testerEtAvancer(")");
+    testerEtAvancer(S_PARENTHESEFERMANTE);
     return chaineEcrire;
 }
 
 Noeud* Interpreteur::instSiRiche() {
     //  <instSiRiche> ::=si(<expression>) <seqInst> {sinonsi(<expression>) <seqInst> }[sinon <seqInst>]finsi
-    NoeudInstSiRiche* instSiRiche = new NoeudInstSiRiche();
-    testerEtAvancer("si");
-    testerEtAvancer("(");
+    NoeudInstSiRiche* instSiRiche = m_arene.creer<NoeudInstSiRiche>();
+    testerEtAvancer(S_SI);
+    testerEtAvancer(S_PARENTHESEOUVRANTE);
     instSiRiche->ajouter(expression());
-    testerEtAvancer(")");
+    testerEtAvancer(S_PARENTHESEFERMANTE);
     instSiRiche->ajouter(seqInst());
-    while (m_lecteur.getSymbole() == "sinonsi") {
-        testerEtAvancer("sinonsi");
-        testerEtAvancer("(");
+    while (m_lecteur.getSymbole().getCode() == S_SINONSI) {
+        testerEtAvancer(S_SINONSI);
+        testerEtAvancer(S_PARENTHESEOUVRANTE);
         instSiRiche->ajouter(expression());
-        testerEtAvancer(")");
+        testerEtAvancer(S_PARENTHESEFERMANTE);
         instSiRiche->ajouter(seqInst());
     }
-    if (m_lecteur.getSymbole() == "sinon") {
-        testerEtAvancer("sinon");
+    if (m_lecteur.getSymbole().getCode() == S_SINON) {
+        testerEtAvancer(S_SINON);
         instSiRiche->ajouter(seqInst());
     }
-    testerEtAvancer("finsi");
+    testerEtAvancer(S_FINSI);
     return instSiRiche;
 }
 
 Noeud* Interpreteur::instLire() {
     // <instLire>::= lire ( <variable> {,<variable>} )
-    testerEtAvancer("lire");
-    testerEtAvancer("(");
-    Noeud* lire = new NoeudInstLire();
-    tester("<VARIABLE>");
+    testerEtAvancer(S_LIRE);
+    testerEtAvancer(S_PARENTHESEOUVRANTE);
+    Noeud* lire = m_arene.creer<NoeudInstLire>();
+    tester(S_VARIABLE);
     Noeud* variable = m_table.chercheAjoute(m_lecteur.getSymbole());
     lire->ajoute(variable);
     m_lecteur.avancer();
-    while (m_lecteur.getSymbole() == ",") {
+    while (m_lecteur.getSymbole().getCode() == S_VIRGULE) {
         m_lecteur.avancer();
-        tester("<VARIABLE>");
+        tester(S_VARIABLE);
         variable = m_table.chercheAjoute(m_lecteur.getSymbole());
         lire->ajoute(variable);
         m_lecteur.avancer();
     }
-    testerEtAvancer(")");
+    testerEtAvancer(S_PARENTHESEFERMANTE);
     return lire;
 }
\ No newline at end of file
@@ -5,17 +5,26 @@
 #include "Lecteur.h"
 #include "Exceptions.h"
 #include "TableSymboles.h"
+#include "TableLitteraux.h"
+#include "TableExpressions.h"
 #include "ArbreAbstrait.h"
+#include "Optimiseur.h"
 
 class Interpreteur {
 public:
     Interpreteur(ifstream & fichier); // Construit un interpréteur pour interpreter
     //  le programme dans  fichier 
+    Interpreteur(Source source, unsigned int nbTaches = 1); // Idem pour le programme contenu dans source
+    //  (fichier projeté en mémoire, tampon, entrée standard...), découpé en symboles par nbTaches
+    //  fils d'exécution si nbTaches != 1 (0 : autant que de coeurs, voir Lecteur)
 
     void analyse(); // Si le contenu du fichier est conforme à la grammaire,
     //   cette méthode se termine normalement et affiche un message "Syntaxe correcte".
-    //   la table des symboles (ts) et l'arbre abstrait (arbre) auront été construits
+    //   la table des symboles (ts) et l'arbre abstrait (arbre) auront été construits,
+    //   et chaque variable de l'arbre aura reçu sa case dans le cadre
     // Sinon, une exception sera levée
+    // Une nouvelle analyse repart du début du texte, après avoir libéré d'un coup l'arbre et la table précédents
+    void optimiser(Optimiseur & optimiseur); // Remplace l'arbre analysé par l'arbre que renvoie optimiseur
 
     inline const TableSymboles & getTable() const {
         return m_table;
@@ -24,9 +33,21 @@ public:
     inline Noeud* getArbre() const {
         return m_arbre;
     } // accesseur
+
+    inline Cadre & getCadre() {
+        return m_cadre;
+    } // accesseur
+
+    inline Arene & getArene() {
+        return m_arene;
+    } // accesseur
 private:
     Lecteur m_lecteur; // Le lecteur de symboles utilisé pour analyser le fichier
-    TableSymboles m_table; // La table des symboles valués
+    Arene m_arene; // L'arène propriétaire de l'arbre, des symboles valués et des littéraux
+    Cadre m_cadre; // Les valeurs des variables, rangées dans des cases contiguës
+    TableSymboles m_table; // La table des symboles valués (les variables)
+    TableLitteraux m_litteraux; // La table des entiers et des chaînes littéraux
+    TableExpressions m_expressions; // La table des opérations, partagées par leurs occurrences
     Noeud* m_arbre; // L'arbre abstrait
 
     // Implémentation de la grammaire
@@ -45,9 +66,11 @@ private:
     Noeud* instSiRiche(); // <instSiRiche> ::=si(<expression>) <seqInst> {sinonsi(<expression>) <seqInst> }[sinon <seqInst>]finsi
     Noeud* instLire(); //<instLire>    ::=lire( <variable> {, <variable> })
     // outils pour simplifier l'analyse syntaxique
-    void tester(const string & symboleAttendu) const throw (SyntaxeException); // Si symbole courant != symboleAttendu, on lève une exception
-    void testerEtAvancer(const string & symboleAttendu) throw (SyntaxeException); // Si symbole courant != symboleAttendu, on lève une exception, sinon on avance
-    void erreur(const string & mess) const throw (SyntaxeException); // Lève une exception "contenant" le message mess
+    void tester(const string & symboleAttendu) const; // Si symbole courant != symboleAttendu, on lève une exception
+    void testerEtAvancer(const string & symboleAttendu); // Si symbole courant != symboleAttendu, on lève une exception, sinon on avance
+    void tester(CodeSymbole codeAttendu) const; // Idem, en comparant le code du symbole courant (sans comparaison de chaînes)
+    void testerEtAvancer(CodeSymbole codeAttendu); // Idem, puis on avance
+    void erreur(const string & mess) const; // Lève une exception "contenant" le message mess
 };
 
 #endif /* INTERPRETEUR_H */
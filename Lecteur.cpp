@@ -2,131 +2,220 @@
 #include "Exceptions.h"
 #include <ctype.h>
 #include <string.h>
+#include <algorithm>
 #include <iostream>
+#include <thread>
 using namespace std;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-Lecteur::Lecteur(ifstream& fichier) :
-m_lecteurCar(fichier), m_symbole("") {
+Lecteur::Lecteur(Source source, unsigned int nbTaches) :
+m_source(move(source)), m_lecteurCar(m_source), m_symbole(""), m_symbolesLus(), m_suivant(0) {
+  if (nbTaches != 1) decouper(nbTaches);
   avancer(); // pour aller lire le premier symbole
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+Lecteur::Lecteur(ifstream& fichier) :
+Lecteur(Source(fichier)) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void Lecteur::avancer() {
-  sauterSeparateurs();
+  if (!m_symbolesLus.empty()) { // le texte a été découpé d'avance : on prend le symbole suivant du tableau
+    const SymboleLu & lu = m_symbolesLus[m_suivant];
+    m_symbole = lu.symbole;
+    m_ligne = lu.ligne;
+    m_colonne = lu.colonne;
+    if (m_suivant + 1 < m_symbolesLus.size()) m_suivant++; // on reste sur la fin de fichier
+    return;
+  }
+  sauterSeparateurs(m_lecteurCar);
   // on est maintenant positionne sur le premier caractère d'un symbole
   m_ligne = m_lecteurCar.getLigne();
   m_colonne = m_lecteurCar.getColonne();
-  m_symbole = Symbole(motSuivant()); // on reconstruit symbole avec le nouveau mot lu
+  m_symbole = Symbole(motSuivant(m_lecteurCar)); // on reconstruit symbole avec le nouveau mot lu
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Lecteur::recommencer() {
+  m_lecteurCar = LecteurCaractere(m_source);
+  m_suivant = 0; // les symboles découpés d'avance restent valables : on les reparcourt
+  avancer();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Lecteur::sauterSeparateurs() {
-  while (m_lecteurCar.getCaractere() == ' ' ||
-          m_lecteurCar.getCaractere() == '\t' ||
-          m_lecteurCar.getCaractere() == '\r' ||
-          m_lecteurCar.getCaractere() == '\n')
-    m_lecteurCar.avancer();
-  if (m_lecteurCar.getCaractere() == '#') {
+void Lecteur::sauterSeparateurs(LecteurCaractere & lecteurCar) {
+  while (lecteurCar.getCaractere() == ' ' ||
+          lecteurCar.getCaractere() == '\t' ||
+          lecteurCar.getCaractere() == '\r' ||
+          lecteurCar.getCaractere() == '\n')
+    lecteurCar.avancer();
+  if (lecteurCar.getCaractere() == '#') {
     do {
-      m_lecteurCar.avancer();
-    } while (m_lecteurCar.getCaractere() != '\r' &&
-            m_lecteurCar.getCaractere() != '\n' &&
-            m_lecteurCar.getCaractere() != EOF);
-    sauterSeparateurs();
+      lecteurCar.avancer();
+    } while (lecteurCar.getCaractere() != '\r' &&
+            lecteurCar.getCaractere() != '\n' &&
+            lecteurCar.getCaractere() != EOF);
+    sauterSeparateurs(lecteurCar);
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-string Lecteur::motSuivant() {
-  string s;
-  s = "";
-  if (isdigit(m_lecteurCar.getCaractere()))
+string_view Lecteur::motSuivant(LecteurCaractere & lecteurCar) {
+  const char * debut = lecteurCar.getPosition(); // le symbole commence sur le caractère courant
+  if (isdigit(lecteurCar.getCaractere()))
     // c'est le début d'un entier
     do {
-      s = s + m_lecteurCar.getCaractere();
-      m_lecteurCar.avancer();
-    } while (isdigit(m_lecteurCar.getCaractere()));
+      lecteurCar.avancer();
+    } while (isdigit(lecteurCar.getCaractere()));
 
-  else if (isalpha(m_lecteurCar.getCaractere()))
+  else if (isalpha(lecteurCar.getCaractere()))
     // c'est le début d'un mot
     do {
-      s = s + m_lecteurCar.getCaractere();
-      m_lecteurCar.avancer();
-    } while (isalpha(m_lecteurCar.getCaractere()) ||
-            isdigit(m_lecteurCar.getCaractere()) ||
-            m_lecteurCar.getCaractere() == '_');
-  else if (m_lecteurCar.getCaractere() == '"') {
+      lecteurCar.avancer();
+    } while (isalpha(lecteurCar.getCaractere()) ||
+            isdigit(lecteurCar.getCaractere()) ||
+            lecteurCar.getCaractere() == '_');
+  else if (lecteurCar.getCaractere() == '"') {
     // c'est le début d'une chaîne
     do {
-      s = s + m_lecteurCar.getCaractere();
-      m_lecteurCar.avancer();
-    } while (m_lecteurCar.getCaractere() != '"' &&
-            m_lecteurCar.getCaractere() != '\n' &&
-            m_lecteurCar.getCaractere() != EOF);
-    if (m_lecteurCar.getCaractere() == '"') {
-      s = s + m_lecteurCar.getCaractere();
-      m_lecteurCar.avancer();
+      lecteurCar.avancer();
+    } while (lecteurCar.getCaractere() != '"' &&
+            lecteurCar.getCaractere() != '\n' &&
+            lecteurCar.getCaractere() != EOF);
+    if (lecteurCar.getCaractere() == '"') {
+      lecteurCar.avancer();
     }
-  } else if (m_lecteurCar.getCaractere() == '=' || m_lecteurCar.getCaractere() == '!' ||
-          m_lecteurCar.getCaractere() == '<' || m_lecteurCar.getCaractere() == '>') {
-    s = s + m_lecteurCar.getCaractere();
-    m_lecteurCar.avancer();
-    if (m_lecteurCar.getCaractere() == '=') {
+  } else if (lecteurCar.getCaractere() == '=' || lecteurCar.getCaractere() == '!' ||
+          lecteurCar.getCaractere() == '<' || lecteurCar.getCaractere() == '>') {
+    lecteurCar.avancer();
+    if (lecteurCar.getCaractere() == '=') {
       // pour lire les symbole == != <= >=
-      s = s + m_lecteurCar.getCaractere();
-      m_lecteurCar.avancer();
+      lecteurCar.avancer();
     }
-  } else if (m_lecteurCar.getCaractere() == '+') {
-    s = s + m_lecteurCar.getCaractere();
-    m_lecteurCar.avancer();
-    if (m_lecteurCar.getCaractere() == '+') {
+  } else if (lecteurCar.getCaractere() == '+') {
+    lecteurCar.avancer();
+    if (lecteurCar.getCaractere() == '+') {
       // pour lire les symbole ++
-      s = s + m_lecteurCar.getCaractere();
-      m_lecteurCar.avancer();
+      lecteurCar.avancer();
     }
-  } else if (m_lecteurCar.getCaractere() == '-') {
-    s = s + m_lecteurCar.getCaractere();
-    m_lecteurCar.avancer();
-    if (m_lecteurCar.getCaractere() == '-') {
+  } else if (lecteurCar.getCaractere() == '-') {
+    lecteurCar.avancer();
+    if (lecteurCar.getCaractere() == '-') {
       // pour lire les symbole --
-      s = s + m_lecteurCar.getCaractere();
-      m_lecteurCar.avancer();
+      lecteurCar.avancer();
     }
-  } else if (m_lecteurCar.getCaractere() != EOF)
+  } else if (lecteurCar.getCaractere() != EOF)
     // c'est un caractere spécial
   {
-    s = m_lecteurCar.getCaractere();
-    m_lecteurCar.avancer();
+    lecteurCar.avancer();
   }
-  return s;
+  return string_view(debut, lecteurCar.getPosition() - debut);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-LecteurCaractere::LecteurCaractere(ifstream & fichier) : m_fichier(fichier) {
-  m_ligne = 1;
-  m_colonne = 0;
-  if (m_fichier.fail()) // si le fichier ne peut-être lu...
-    throw FichierException();
-  avancer();
+bool Lecteur::lireTranche(const char * debut, const char * fin, vector<SymboleLu> & symboles) {
+  LecteurCaractere lecteurCar(debut, fin, 1);
+  SymboleLu lu;
+  do {
+    sauterSeparateurs(lecteurCar);
+    lu.ligne = lecteurCar.getLigne();
+    lu.colonne = lecteurCar.getColonne();
+    lu.symbole = Symbole(motSuivant(lecteurCar));
+    symboles.push_back(lu);
+  } while (lu.symbole.getCode() != S_FINDEFICHIER);
+  return lecteurCar.getPosition() == fin;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void LecteurCaractere::avancer() {
-  if (m_fichier.peek() == EOF)
-    m_caractere = EOF;
-  else {
-    if (m_caractere == '\n') {
-      m_colonne = 0;
-      m_ligne++;
+static const size_t TAILLE_TRANCHE_MIN = 256 * 1024; // en dessous, un fil d'exécution de plus ne rapporte rien
+
+template <class Tache>
+static void enParallele(size_t nbTaches, Tache tache) {
+  // Exécute tache(0), ..., tache(nbTaches - 1), chacune dans son propre fil d'exécution
+  vector<thread> fils;
+  for (size_t i = 1; i < nbTaches; i++)
+    fils.emplace_back(tache, i);
+  tache(0);
+  for (thread & f : fils) f.join();
+}
+
+void Lecteur::decouper(unsigned int nbTaches) {
+  if (nbTaches == 0) nbTaches = max(1u, thread::hardware_concurrency());
+  const char * debut = m_source.getDebut();
+  const char * fin = m_source.getFin();
+  // Chaque tranche, sauf la première, commence juste après un '\n' : aucun symbole ne continue
+  // sur la ligne suivante (les commentaires # et les chaînes "..." s'arrêtent en fin de ligne),
+  // donc chaque tranche peut être lue indépendamment, à partir de la colonne 0
+  vector<const char *> bornes(1, debut);
+  size_t tailleTranche = max(m_source.getTaille() / nbTaches + 1, TAILLE_TRANCHE_MIN);
+  while ((size_t) (fin - bornes.back()) > tailleTranche) {
+    const char * cible = bornes.back() + tailleTranche;
+    const char * finLigne = (const char *) memchr(cible, '\n', fin - cible);
+    if (finLigne == nullptr || finLigne + 1 == fin) break;
+    bornes.push_back(finLigne + 1);
+  }
+  bornes.push_back(fin);
+  size_t nbTranches = bornes.size() - 1;
+  if (nbTranches < 2) return; // texte trop petit : on lira à la demande
+
+  vector<vector<SymboleLu> > tranches(nbTranches);
+  vector<unsigned int> nbLignes(nbTranches);
+  vector<char> complete(nbTranches);
+  enParallele(nbTranches, [&](size_t i) {
+    complete[i] = lireTranche(bornes[i], bornes[i + 1], tranches[i]);
+    nbLignes[i] = count(bornes[i], bornes[i + 1], '\n');
+  });
+
+  // Position de chaque tranche dans le tableau final : la fin de fichier de chaque tranche est retirée,
+  // sauf pour la dernière, ou pour une tranche interrompue par un caractère EOF (la suite est illisible)
+  vector<size_t> premierSymbole(nbTranches);
+  vector<size_t> nbSymboles(nbTranches);
+  vector<unsigned int> lignesAvant(nbTranches);
+  size_t total = 0;
+  unsigned int lignes = 0;
+  size_t nbUtiles = nbTranches;
+  for (size_t i = 0; i < nbTranches; i++) {
+    premierSymbole[i] = total;
+    lignesAvant[i] = lignes;
+    bool derniere = (i == nbTranches - 1 || !complete[i]);
+    nbSymboles[i] = tranches[i].size() - (derniere ? 0 : 1);
+    total += nbSymboles[i];
+    lignes += nbLignes[i];
+    if (derniere) {
+      nbUtiles = i + 1;
+      break;
     }
-    m_fichier.get(m_caractere);
-    m_colonne++;
   }
+  m_symbolesLus.resize(total);
+  enParallele(nbUtiles, [&](size_t i) {
+    for (size_t j = 0; j < nbSymboles[i]; j++) {
+      SymboleLu & lu = m_symbolesLus[premierSymbole[i] + j];
+      lu = tranches[i][j];
+      lu.ligne += lignesAvant[i];
+    }
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+LecteurCaractere::LecteurCaractere(const Source & source) :
+LecteurCaractere(source.getDebut(), source.getFin(), 1) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+LecteurCaractere::LecteurCaractere(const char * debut, const char * fin, unsigned int ligne) :
+m_courant(debut), m_suivant(debut), m_fin(fin), m_caractere('\0') {
+  m_ligne = ligne;
+  m_colonne = 0;
+  avancer();
 }
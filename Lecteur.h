@@ -1,17 +1,22 @@
 #ifndef LECTEUR_H
 #define LECTEUR_H
 
+#include <cstdio>
 #include <fstream>
 #include <string>
+#include <vector>
 using namespace std;
 
 #include "Symbole.h"
+#include "Source.h"
 
-// Lecteur pour parcourir un fichier texte caractère par caractère
+// Lecteur pour parcourir un texte caractère par caractère
 
 class LecteurCaractere {
 public:
-    LecteurCaractere(ifstream & fichier); // Construit le lecteur pour parcourir fichier
+    LecteurCaractere(const Source & source); // Construit le lecteur pour parcourir le texte de source
+    LecteurCaractere(const char * debut, const char * fin, unsigned int ligne);
+    // Construit le lecteur pour parcourir la tranche [debut, fin[ d'un texte, qui commence en début de ligne ligne
 
     inline char getCaractere() const {
         return m_caractere;
@@ -24,21 +29,51 @@ public:
     inline unsigned int getColonne() const {
         return m_colonne;
     } // Colonne du caractère courant
-    void avancer(); // Passe au caractere suivant, s'il existe, sinon reste sur le caractère de fin de fichier (EOF)
+    inline const char * getPosition() const {
+        return m_courant;
+    } // Adresse du caractère courant dans le texte (la fin du texte si on est sur EOF)
+
+    inline void avancer() {
+        if (m_suivant == m_fin) {
+            m_caractere = EOF;
+            m_courant = m_fin;
+        } else {
+            if (m_caractere == '\n') {
+                m_colonne = 0;
+                m_ligne++;
+            }
+            m_courant = m_suivant++;
+            m_caractere = *m_courant;
+            m_colonne++;
+        }
+    } // Passe au caractere suivant, s'il existe, sinon reste sur le caractère de fin de fichier (EOF)
 
 private:
-    ifstream& m_fichier; // Le fichier texte que l'on parcourt
+    const char * m_courant; // Le caractère courant dans le texte
+    const char * m_suivant; // Le prochain caractère à lire dans le texte
+    const char * m_fin; // La fin du texte que l'on parcourt
     char m_caractere; // Le caractere courant
     unsigned int m_ligne; // Ligne du caractere courant dans le fichier
     unsigned int m_colonne; // Colonne du caractere courant dans le fichier
 };
 
-// Lecteur pour parcourir un fichier texte symbole par symbole
+// Symbole lu à l'avance, avec ses coordonnées dans le texte (découpage parallèle du texte)
+
+struct SymboleLu {
+    Symbole symbole;
+    unsigned int ligne, colonne;
+};
+
+// Lecteur pour parcourir un texte symbole par symbole
 
 class Lecteur {
 public:
-    Lecteur(ifstream & fichier); // Résultat : symbole = premier symbole du fichier
+    Lecteur(Source source, unsigned int nbTaches = 1); // Résultat : symbole = premier symbole du texte
+    // Si nbTaches != 1, les gros textes sont découpés d'avance en symboles par nbTaches fils d'exécution
+    //  (0 : autant que de coeurs), et avancer() ne fait plus que parcourir le tableau des symboles lus
+    Lecteur(ifstream & fichier); // Idem, le fichier étant lu d'un bloc
     void avancer(); // Passe au symbole suivant du fichier
+    void recommencer(); // Revient au premier symbole du texte (pour l'analyser à nouveau)
 
     inline const Symbole& getSymbole() const {
         return m_symbole;
@@ -53,11 +88,19 @@ public:
     } // Colonne du symbole courant
 
 private:
+    Source m_source; // Le texte parcouru (doit être construit avant m_lecteurCar)
     LecteurCaractere m_lecteurCar; // Le lecteur de caractères utilisé
     Symbole m_symbole; // Le symbole courant du lecteur de symboles
     unsigned int m_ligne, m_colonne; // Coordonnees, dans le fichier, du symbole courant
-    void sauterSeparateurs(); // Saute avec m_lecteurCar une suite de séparateurs, commentaires consécutifs
-    string motSuivant(); // Lit avec m_lecteurCar la chaîne du prochain symbole et la renvoie en résultat
+    vector<SymboleLu> m_symbolesLus; // Les symboles découpés d'avance (vide si on lit à la demande)
+    size_t m_suivant; // Indice dans m_symbolesLus du prochain symbole
+    static void sauterSeparateurs(LecteurCaractere & lecteurCar); // Saute avec lecteurCar une suite de séparateurs, commentaires consécutifs
+    static string_view motSuivant(LecteurCaractere & lecteurCar); // Lit avec lecteurCar la chaîne du prochain symbole et la renvoie en résultat
+    //  (sous forme de tranche du texte source : aucune chaîne n'est construite)
+    static bool lireTranche(const char * debut, const char * fin, vector<SymboleLu> & symboles);
+    // Découpe en symboles la tranche [debut, fin[ (lignes numérotées à partir de 1), fin de fichier comprise
+    // Renvoie faux si la lecture s'est arrêtée avant la fin de la tranche (caractère EOF dans le texte)
+    void decouper(unsigned int nbTaches); // Découpe tout le texte en parallèle dans m_symbolesLus
 };
 
 #endif /* LECTEUR_H */ 
@@ -0,0 +1,483 @@
+#include "MachineVirtuelle.h"
+#include "Exceptions.h"
+#include "Operations.h"
+#include <cstring>
+#include <iostream>
+using namespace std;
+
+static const size_t AUCUN_SAUT = SIZE_MAX;
+
+////////////////////////////////////////////////////////////////////////////////
+
+static CodeOperation operationRR(CodeSymbole operateur) {
+  switch (operateur) {
+#define X(nom) case S_##nom: return OP_##nom;
+      OPERATEURS_BINAIRES(X)
+#undef X
+    default: return OP_INTERDIT;
+  }
+}
+
+static CodeOperation operationRI(CodeSymbole operateur) {
+  switch (operateur) {
+#define X(nom) case S_##nom: return OP_##nom##_I;
+      OPERATEURS_BINAIRES(X)
+#undef X
+    default: return OP_INTERDIT;
+  }
+}
+
+static CodeOperation sautSiRR(CodeSymbole comparaison) {
+  switch (comparaison) {
+#define X(nom) case S_##nom: return OP_SI_##nom;
+      COMPARAISONS(X)
+#undef X
+    default: return OP_INTERDIT;
+  }
+}
+
+static CodeOperation sautSiRI(CodeSymbole comparaison) {
+  switch (comparaison) {
+#define X(nom) case S_##nom: return OP_SI_##nom##_I;
+      COMPARAISONS(X)
+#undef X
+    default: return OP_INTERDIT;
+  }
+}
+
+static CodeOperation boucler(CodeOperation sautSi) {
+  // BOUCLER_<cmp> qui correspond à SI_<cmp>_I, OP_INTERDIT pour une autre instruction
+  switch (sautSi) {
+#define X(nom) case OP_SI_##nom##_I: return OP_BOUCLER_##nom;
+      COMPARAISONS(X)
+#undef X
+    default: return OP_INTERDIT;
+  }
+}
+
+static bool estComparaison(CodeSymbole operateur) {
+  return sautSiRR(operateur) != OP_INTERDIT;
+}
+
+static CodeSymbole contraire(CodeSymbole comparaison) {
+  // non (a cmp b) == a contraire(cmp) b
+  switch (comparaison) {
+    case S_EGAL: return S_DIFFERENT;
+    case S_DIFFERENT: return S_EGAL;
+    case S_INFERIEUR: return S_SUPERIEUREGAL;
+    case S_SUPERIEUREGAL: return S_INFERIEUR;
+    case S_SUPERIEUR: return S_INFERIEUREGAL;
+    case S_INFERIEUREGAL: return S_SUPERIEUR;
+    default: return comparaison;
+  }
+}
+
+static CodeSymbole miroir(CodeSymbole operateur) {
+  // a op b == b miroir(op) a, S_INDEFINI si l'opérateur n'a pas de miroir (- et /)
+  switch (operateur) {
+    case S_PLUS: case S_MULTIPLIE: case S_EGAL: case S_DIFFERENT:
+      return operateur;
+    case S_INFERIEUR: return S_SUPERIEUR;
+    case S_SUPERIEUR: return S_INFERIEUR;
+    case S_INFERIEUREGAL: return S_SUPERIEUREGAL;
+    case S_SUPERIEUREGAL: return S_INFERIEUREGAL;
+    default: return S_INDEFINI;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+MachineVirtuelle::MachineVirtuelle(const ArbrePlat & plat) :
+m_plat(plat), m_cadre(plat.getCadre()), m_code(), m_nbVariables(plat.getCadre().getTaille()),
+m_temporaire(0), m_nbRegistres(plat.getCadre().getTaille()), m_definies(m_nbVariables, false), m_threade(false) {
+  compilerInstruction(plat.getRacine());
+  emettre(OP_FIN);
+}
+
+size_t MachineVirtuelle::emettre(CodeOperation operation, int32_t a, int32_t b, int32_t c) {
+  m_code.push_back({nullptr, operation, a, b, c, 0});
+  return m_code.size() - 1;
+}
+
+void MachineVirtuelle::corriger(const vector<size_t> & sauts, size_t cible) {
+  for (size_t saut : sauts) m_code[saut].c = cible;
+}
+
+void MachineVirtuelle::fusionnerBoucle(size_t test, size_t corps) {
+  // ... corps: ... ; PLUS_I v v k ; test: SI_<cmp>_I v j corps  ->  ... ; BOUCLER_<cmp> v k j corps ; test: (inchangé)
+  //  Le test reste en place : c'est la première entrée dans la boucle, et la cible des sauts vers la fin du corps
+  if (test <= corps || m_code.size() != test + 1) return; // corps vide, ou test en plusieurs instructions
+  const Instruction & saut = m_code[test];
+  Instruction & increment = m_code[test - 1];
+  CodeOperation fusion = boucler(saut.operation);
+  if (fusion == OP_INTERDIT || saut.c != (int32_t) corps || saut.a >= (int32_t) m_nbVariables) return;
+  if ((increment.operation != OP_PLUS_I && increment.operation != OP_MOINS_I)
+      || increment.a != saut.a || increment.b != saut.a) return;
+  int32_t pas = increment.operation == OP_PLUS_I ? increment.c : calculerUnaire(S_MOINS, increment.c);
+  increment = {nullptr, fusion, saut.a, pas, saut.b, (int32_t) corps};
+}
+
+unsigned int MachineVirtuelle::temporaire() {
+  unsigned int registre = m_nbVariables + m_temporaire++;
+  if (registre >= m_nbRegistres) m_nbRegistres = registre + 1;
+  return registre;
+}
+
+int MachineVirtuelle::registre(Operande operande) {
+  if (!operande.immediat) return operande.valeur;
+  unsigned int t = temporaire();
+  emettre(OP_CHARGER, t, operande.valeur);
+  return t;
+}
+
+void MachineVirtuelle::lireVariable(unsigned int variable) {
+  if (!m_definies[variable]) {
+    emettre(OP_VERIFIER, variable);
+    m_definies[variable] = true; // si la vérification passe, la variable est définie pour la suite
+  }
+}
+
+void MachineVirtuelle::definirVariable(unsigned int variable) {
+  if (!m_definies[variable]) {
+    emettre(OP_DEFINIR, variable);
+    m_definies[variable] = true;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+MachineVirtuelle::Operande MachineVirtuelle::compilerExpression(uint32_t i, int destination) {
+  const NoeudPlat & n = m_plat.getNoeud(i);
+  switch (n.genre) {
+    case P_VARIABLE:
+      lireVariable(n.a);
+      if (destination >= 0 && destination != (int) n.a) {
+        emettre(OP_COPIER, destination, n.a);
+        return {false, destination};
+      }
+      return {false, (int) n.a};
+    case P_ENTIER:
+      if (destination >= 0) {
+        emettre(OP_CHARGER, destination, (int) n.a);
+        return {false, destination};
+      }
+      return {true, (int) n.a};
+    case P_OPERATEUR: {
+      // Les opérandes sont évalués dans l'ordre, puis une seule instruction calcule et écrit le résultat :
+      //  la destination (éventuellement la variable affectée) n'est modifiée qu'une fois tout calculé
+      unsigned int sauve = m_temporaire;
+      CodeSymbole operateur = (CodeSymbole) n.code;
+      Operande g = compilerExpression(n.a);
+      int resultat = (destination >= 0) ? destination : m_nbVariables + sauve;
+      Operande d = compilerExpression(n.b);
+      if (!d.immediat && g.immediat && miroir(operateur) != S_INDEFINI)
+        emettre(operationRI(miroir(operateur)), resultat, d.valeur, g.valeur);
+      else if (d.immediat)
+        emettre(operationRI(operateur), resultat, registre(g), d.valeur);
+      else
+        emettre(operationRR(operateur), resultat, registre(g), d.valeur);
+      m_temporaire = sauve;
+      if (destination < 0) temporaire(); // le résultat occupe le premier temporaire libre
+      return {false, resultat};
+    }
+    case P_UNAIRE: {
+      unsigned int sauve = m_temporaire;
+      Operande operande = compilerExpression(n.a);
+      int resultat = (destination >= 0) ? destination : m_nbVariables + sauve;
+      emettre(n.code == S_NON ? OP_NON : OP_OPPOSE, resultat, registre(operande));
+      m_temporaire = sauve;
+      if (destination < 0) temporaire();
+      return {false, resultat};
+    }
+    case P_LOGIQUE: {
+      // et, ou : des sauts conditionnels, comme pour une condition ; le résultat n'est écrit qu'à la fin
+      unsigned int sauve = m_temporaire;
+      int resultat = (destination >= 0) ? destination : m_nbVariables + sauve;
+      vector<size_t> versFaux;
+      compilerCondition(i, false, versFaux);
+      emettre(OP_CHARGER, resultat, 1);
+      vector<size_t> versFin{emettre(OP_SAUT)};
+      corriger(versFaux, m_code.size());
+      emettre(OP_CHARGER, resultat, 0);
+      corriger(versFin, m_code.size());
+      if (destination < 0) temporaire();
+      return {false, resultat};
+    }
+    case P_EXTERNE: {
+      int resultat = (destination >= 0) ? destination : (int) temporaire();
+      emettre(OP_DELEGUER, resultat, n.a);
+      return {false, resultat};
+    }
+    default: // une chaîne (ou une instruction) n'a pas de valeur entière
+      emettre(OP_INTERDIT);
+      return {true, 0};
+  }
+}
+
+void MachineVirtuelle::compilerCondition(uint32_t i, bool sautSiVrai, vector<size_t> & sauts) {
+  const NoeudPlat & n = m_plat.getNoeud(i);
+  unsigned int sauve = m_temporaire;
+  size_t saut = AUCUN_SAUT;
+  if (n.genre == P_UNAIRE && n.code == S_NON) {
+    compilerCondition(n.a, !sautSiVrai, sauts); // saut si non a vaut v : saut si a vaut non v
+    return;
+  }
+  if (n.genre == P_LOGIQUE) {
+    // Le second opérande n'est évalué que si le premier ne décide pas : on saute directement à la cible
+    //  quand il suffit, sinon par-dessus le test du second. Ses lectures de variables ne sont donc pas
+    //  sûrement faites : on oublie les variables qu'il a vérifiées.
+    bool decideSi = (n.code == S_OU); // valeur du premier opérande qui décide (vrai pour ou, faux pour et)
+    vector<size_t> versSuite;
+    compilerCondition(n.a, decideSi, decideSi == sautSiVrai ? sauts : versSuite);
+    vector<bool> avant = m_definies;
+    compilerCondition(n.b, sautSiVrai, sauts);
+    m_definies = avant;
+    corriger(versSuite, m_code.size());
+    return;
+  }
+  if (n.genre == P_OPERATEUR && estComparaison((CodeSymbole) n.code)) {
+    // comparaison : un seul saut conditionnel fusionné, sans calculer la valeur booléenne
+    CodeSymbole comparaison = sautSiVrai ? (CodeSymbole) n.code : contraire((CodeSymbole) n.code);
+    Operande g = compilerExpression(n.a);
+    Operande d = compilerExpression(n.b);
+    if (g.immediat && !d.immediat)
+      saut = emettre(sautSiRI(miroir(comparaison)), d.valeur, g.valeur);
+    else if (d.immediat)
+      saut = emettre(sautSiRI(comparaison), registre(g), d.valeur);
+    else
+      saut = emettre(sautSiRR(comparaison), g.valeur, d.valeur);
+  } else {
+    Operande valeur = compilerExpression(i);
+    if (!valeur.immediat)
+      saut = emettre(sautSiVrai ? OP_SAUTSI : OP_SAUTSINON, 0, valeur.valeur);
+    else if ((valeur.valeur != 0) == sautSiVrai)
+      saut = emettre(OP_SAUT);
+  }
+  if (saut != AUCUN_SAUT) sauts.push_back(saut);
+  m_temporaire = sauve;
+}
+
+void MachineVirtuelle::affecter(uint32_t i, Operande valeur) {
+  const NoeudPlat & n = m_plat.getNoeud(i);
+  if (n.genre == P_VARIABLE) {
+    if (valeur.immediat) emettre(OP_CHARGER, n.a, valeur.valeur);
+    else if (valeur.valeur != (int) n.a) emettre(OP_COPIER, n.a, valeur.valeur);
+    definirVariable(n.a);
+  } else if (n.genre == P_EXTERNE) {
+    emettre(OP_DELEGUERAFFECTATION, n.a, registre(valeur));
+  } else {
+    emettre(OP_INTERDIT);
+  }
+}
+
+void MachineVirtuelle::compilerInstruction(uint32_t i) {
+  const NoeudPlat & n = m_plat.getNoeud(i);
+  unsigned int sauve = m_temporaire;
+  switch (n.genre) {
+    case P_SEQUENCE:
+      for (uint32_t j = 0; j < n.b; j++) compilerInstruction(m_plat.getFils(n, j));
+      break;
+    case P_AFFECTATION:
+      if (m_plat.getNoeud(n.a).genre == P_VARIABLE) { // le résultat est calculé directement dans la variable
+        compilerExpression(n.b, m_plat.getNoeud(n.a).a);
+        definirVariable(m_plat.getNoeud(n.a).a);
+      } else {
+        affecter(n.a, compilerExpression(n.b));
+      }
+      break;
+    case P_SIRICHE: { // fils : condition, séquence, condition, séquence..., [séquence du sinon]
+      uint32_t nbCouples = n.b / 2;
+      bool sinon = n.b % 2;
+      vector<size_t> versFin;
+      vector<bool> definiesFin;
+      bool premiereBranche = true;
+      for (uint32_t j = 0; j < nbCouples; j++) {
+        vector<size_t> versSuivante;
+        compilerCondition(m_plat.getFils(n, 2 * j), false, versSuivante);
+        vector<bool> apresCondition = m_definies;
+        compilerInstruction(m_plat.getFils(n, 2 * j + 1));
+        if (j + 1 < nbCouples || sinon) versFin.push_back(emettre(OP_SAUT));
+        for (size_t v = 0; v < m_definies.size(); v++) // les variables sûrement définies après le si
+          m_definies[v] = m_definies[v] && (premiereBranche || definiesFin[v]); //  le sont dans chaque branche
+        definiesFin = m_definies;
+        premiereBranche = false;
+        m_definies = apresCondition;
+        corriger(versSuivante, m_code.size());
+      }
+      if (sinon) compilerInstruction(m_plat.getFils(n, n.b - 1));
+      for (size_t v = 0; v < m_definies.size(); v++)
+        m_definies[v] = m_definies[v] && (premiereBranche || definiesFin[v]);
+      corriger(versFin, m_code.size());
+      break;
+    }
+    case P_TANTQUE:
+    case P_POUR: {
+      // [initialisation] SAUT test ; corps: séquence [action] ; test: saut vers corps si la condition est vraie
+      uint32_t condition = n.a, sequence = n.b, action = ArbrePlat::AUCUN;
+      if (n.genre == P_POUR) {
+        if (m_plat.getFils(n, 0) != ArbrePlat::AUCUN) compilerInstruction(m_plat.getFils(n, 0));
+        condition = m_plat.getFils(n, 1);
+        action = m_plat.getFils(n, 2);
+        sequence = m_plat.getFils(n, 3);
+      }
+      vector<bool> entree = m_definies; // au premier test, seules les variables définies avant la boucle le sont
+      vector<size_t> versTest{emettre(OP_SAUT)}, versCorps;
+      size_t corps = m_code.size();
+      compilerInstruction(sequence);
+      if (action != ArbrePlat::AUCUN) compilerInstruction(action);
+      m_definies = entree;
+      size_t test = m_code.size();
+      corriger(versTest, test);
+      compilerCondition(condition, true, versCorps);
+      corriger(versCorps, corps);
+      fusionnerBoucle(test, corps);
+      break;
+    }
+    case P_REPETER: {
+      size_t corps = m_code.size();
+      compilerInstruction(n.a);
+      vector<size_t> versCorps;
+      compilerCondition(n.b, false, versCorps);
+      corriger(versCorps, corps);
+      break;
+    }
+    case P_ECRIRE:
+      for (uint32_t j = 0; j < n.b; j++) {
+        const NoeudPlat & parametre = m_plat.getNoeud(m_plat.getFils(n, j));
+        if (parametre.genre == P_CHAINE) emettre(OP_ECRIRECHAINE, parametre.a);
+        else emettre(OP_ECRIRE, registre(compilerExpression(m_plat.getFils(n, j))));
+        m_temporaire = sauve;
+      }
+      break;
+    case P_LIRE:
+      for (uint32_t j = 0; j < n.b; j++) {
+        const NoeudPlat & variable = m_plat.getNoeud(m_plat.getFils(n, j));
+        if (variable.genre == P_VARIABLE) {
+          emettre(OP_LIRE, variable.a);
+          definirVariable(variable.a);
+        } else {
+          unsigned int t = temporaire();
+          emettre(OP_LIRE, t);
+          affecter(m_plat.getFils(n, j), {false, (int) t});
+        }
+        m_temporaire = sauve;
+      }
+      break;
+    default: // expression isolée, noeud externe
+      compilerExpression(i);
+      break;
+  }
+  m_temporaire = sauve;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define SUIVANTE() goto *(++ip)->etiquette
+#define SAUTER(cible) do { ip = debut + (cible); goto *ip->etiquette; } while (0)
+
+int MachineVirtuelle::executer() {
+#define X(nom) &&L_##nom,
+  static const void * const ETIQUETTES[] = {X_OPERATIONS_VM};
+#undef X
+  if (!m_threade) { // aiguillage direct : chaque instruction porte l'adresse du code qui l'exécute
+    for (Instruction & instruction : m_code) instruction.etiquette = ETIQUETTES[instruction.operation];
+    m_threade = true;
+  }
+  vector<int> registres(m_nbRegistres, 0);
+  int * r = registres.data();
+  int * valeurs = m_cadre.getValeurs();
+  size_t tailleVariables = m_nbVariables * sizeof (int);
+  memcpy(r, valeurs, tailleVariables);
+  const Instruction * debut = m_code.data();
+  const Instruction * ip = debut;
+  try {
+    goto *ip->etiquette;
+
+L_CHARGER:
+    r[ip->a] = ip->b;
+    SUIVANTE();
+L_COPIER:
+    r[ip->a] = r[ip->b];
+    SUIVANTE();
+#define X(nom) \
+L_##nom: \
+    r[ip->a] = calculer(S_##nom, r[ip->b], r[ip->c]); \
+    SUIVANTE(); \
+L_##nom##_I: \
+    r[ip->a] = calculer(S_##nom, r[ip->b], ip->c); \
+    SUIVANTE();
+    OPERATEURS_BINAIRES(X)
+#undef X
+L_NON:
+    r[ip->a] = !r[ip->b];
+    SUIVANTE();
+L_OPPOSE:
+    r[ip->a] = calculerUnaire(S_MOINS, r[ip->b]);
+    SUIVANTE();
+L_SAUT:
+    SAUTER(ip->c);
+L_SAUTSI:
+    if (r[ip->b]) SAUTER(ip->c);
+    SUIVANTE();
+L_SAUTSINON:
+    if (!r[ip->b]) SAUTER(ip->c);
+    SUIVANTE();
+#define X(nom) \
+L_SI_##nom: \
+    if (calculer(S_##nom, r[ip->a], r[ip->b])) SAUTER(ip->c); \
+    SUIVANTE(); \
+L_SI_##nom##_I: \
+    if (calculer(S_##nom, r[ip->a], ip->b)) SAUTER(ip->c); \
+    SUIVANTE();
+    COMPARAISONS(X)
+#undef X
+#define X(nom) \
+L_BOUCLER_##nom: \
+    r[ip->a] = calculer(S_PLUS, r[ip->a], ip->b); \
+    if (calculer(S_##nom, r[ip->a], ip->c)) SAUTER(ip->d); \
+    SUIVANTE();
+    COMPARAISONS(X)
+#undef X
+L_VERIFIER:
+    if (!m_cadre.estDefini(ip->a)) throw IndefiniException();
+    SUIVANTE();
+L_DEFINIR:
+    m_cadre.definir(ip->a);
+    SUIVANTE();
+L_ECRIRE:
+    cout << r[ip->a];
+    SUIVANTE();
+L_ECRIRECHAINE:
+    cout << m_plat.getChaine(ip->a);
+    SUIVANTE();
+L_LIRE:
+    {
+      int valeur;
+      cin >> valeur;
+      r[ip->a] = valeur;
+    }
+    SUIVANTE();
+L_DELEGUER:
+    { // le noeud externe travaille sur le cadre : on y range les variables avant, et on les recharge après
+      memcpy(valeurs, r, tailleVariables);
+      int valeur = m_plat.getExterne(ip->b)->executer();
+      memcpy(r, valeurs, tailleVariables);
+      r[ip->a] = valeur;
+    }
+    SUIVANTE();
+L_DELEGUERAFFECTATION:
+    memcpy(valeurs, r, tailleVariables);
+    m_plat.getExterne(ip->a)->affecter(r[ip->b]);
+    memcpy(r, valeurs, tailleVariables);
+    SUIVANTE();
+L_INTERDIT:
+    throw OperationInterditeException();
+L_FIN:
+    ;
+  } catch (...) {
+    memcpy(valeurs, r, tailleVariables); // le cadre garde les valeurs calculées avant l'erreur
+    throw;
+  }
+  memcpy(valeurs, r, tailleVariables);
+  return 0;
+}
@@ -0,0 +1,118 @@
+#ifndef MACHINEVIRTUELLE_H
+#define MACHINEVIRTUELLE_H
+
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+#include "ArbrePlat.h"
+#include "Operations.h"
+#include "Symbole.h"
+
+// Chaque opérateur binaire (voir Operations.h) a une instruction de la machine, et chaque comparaison
+// a en plus une instruction de saut conditionnel fusionnée
+#define OPERATION_RR(nom) X(nom)
+#define OPERATION_RI(nom) X(nom##_I)
+#define OPERATION_SI_RR(nom) X(SI_##nom)
+#define OPERATION_SI_RI(nom) X(SI_##nom##_I)
+#define OPERATION_BOUCLER(nom) X(BOUCLER_##nom)
+
+// Jeu d'instructions. Les opérandes a, b, c sont des numéros de registre (r), des valeurs immédiates (i)
+// ou des numéros d'instruction (cible d'un saut, toujours dans c, sauf pour BOUCLER où elle est dans d).
+//   CHARGER ra i           COPIER ra rb           <op> ra rb rc : ra = rb op rc      <op>_I ra rb i : ra = rb op i
+//   NON ra rb              OPPOSE ra rb : ra = -rb
+//   SAUT c                 SAUTSI rb c / SAUTSINON rb c : saut si rb est vrai / faux
+//   SI_<cmp> ra rb c       SI_<cmp>_I ra i c : saut si ra cmp rb (ra cmp i)
+//   BOUCLER_<cmp> ra i j d : ra = ra + i, puis saut si ra cmp j (fin du corps d'une boucle sur un compteur)
+//   VERIFIER ra : IndefiniException si la variable ra n'est pas définie    DEFINIR ra : la variable ra devient définie
+//   ECRIRE ra              ECRIRECHAINE i (indice de la chaîne dans l'arbre aplati)         LIRE ra
+//   DELEGUER ra i : ra = executer() du noeud externe i     DELEGUERAFFECTATION i rb : affecter(rb) au noeud externe i
+//   INTERDIT : OperationInterditeException (valeur d'une chaîne)      FIN
+#define X_OPERATIONS_VM \
+    X(CHARGER) X(COPIER) \
+    OPERATEURS_BINAIRES(OPERATION_RR) OPERATEURS_BINAIRES(OPERATION_RI) \
+    X(NON) X(OPPOSE) X(SAUT) X(SAUTSI) X(SAUTSINON) \
+    COMPARAISONS(OPERATION_SI_RR) COMPARAISONS(OPERATION_SI_RI) COMPARAISONS(OPERATION_BOUCLER) \
+    X(VERIFIER) X(DEFINIR) X(ECRIRE) X(ECRIRECHAINE) X(LIRE) X(DELEGUER) X(DELEGUERAFFECTATION) \
+    X(INTERDIT) X(FIN)
+
+#define X(nom) OP_##nom,
+enum CodeOperation : uint16_t {
+    X_OPERATIONS_VM
+    NB_OPERATIONS_VM
+};
+#undef X
+
+struct Instruction {
+    const void * etiquette; // Adresse du code qui exécute l'instruction (remplie à la première exécution)
+    CodeOperation operation;
+    int32_t a, b, c, d;
+};
+
+// MachineVirtuelle compile l'arbre aplati d'un programme en une suite d'instructions à registres,
+// puis l'exécute dans une seule boucle à aiguillage direct (goto calculé sur l'adresse rangée dans
+// chaque instruction), sans appel récursif ni virtuel.
+// Les registres 0 .. nbCases-1 sont les cases du cadre (une par variable) ; les suivants sont des
+// temporaires. Les cases sont chargées du cadre au début de l'exécution et y sont rangées à la fin
+// (et autour de chaque appel d'un noeud externe), les bits "défini" étant directement ceux du cadre.
+// A la compilation, on suit les variables sûrement définies à chaque point du programme : seules
+// les lectures des autres sont précédées d'un VERIFIER, et seule la première affectation d'une
+// variable sur un chemin est suivie d'un DEFINIR.
+// Quand le corps d'une boucle finit par l'incrément du compteur que teste sa condition (i = i + 1 ;
+// i < 500), l'incrément et le test sont fusionnés en une instruction BOUCLER qui revient au corps.
+
+class MachineVirtuelle {
+public:
+    MachineVirtuelle(const ArbrePlat & plat); // Compile l'arbre aplati plat (dont le cadre contient les variables)
+    int executer(); // Exécute le programme compilé
+
+    inline const vector<Instruction> & getCode() const {
+        return m_code;
+    } // accesseur
+
+    inline const ArbrePlat & getPlat() const {
+        return m_plat;
+    } // accesseur
+
+    inline unsigned int getNbVariables() const {
+        return m_nbVariables;
+    } // accesseur
+
+    inline unsigned int getNbRegistres() const {
+        return m_nbRegistres;
+    } // accesseur
+
+private:
+    struct Operande {
+        bool immediat; // vrai : valeur est une constante, faux : valeur est un numéro de registre
+        int valeur;
+    }; // Résultat de la compilation d'une expression
+
+    const ArbrePlat & m_plat; // L'arbre compilé
+    Cadre & m_cadre; // Le cadre des variables
+    vector<Instruction> m_code; // Le programme compilé
+    unsigned int m_nbVariables; // Nombre de registres qui sont des cases du cadre
+    unsigned int m_temporaire; // Nombre de temporaires en cours d'utilisation pendant la compilation
+    unsigned int m_nbRegistres; // Nombre total de registres nécessaires
+    vector<bool> m_definies; // Variables sûrement définies au point de compilation courant
+    bool m_threade; // indique si les étiquettes des instructions ont été remplies
+
+    size_t emettre(CodeOperation operation, int32_t a = 0, int32_t b = 0, int32_t c = 0); // Ajoute une instruction
+    void fusionnerBoucle(size_t test, size_t corps);
+    // Fusionne l'incrément qui précède le test de boucle (instruction test) et ce test en un BOUCLER vers corps
+    void corriger(const vector<size_t> & sauts, size_t cible); // Fixe la cible des instructions de saut sauts
+    unsigned int temporaire(); // Réserve un nouveau temporaire
+    int registre(Operande operande); // Met operande dans un registre (un temporaire si c'est une constante)
+
+    void compilerInstruction(uint32_t i); // Compile le noeud i, une instruction
+    Operande compilerExpression(uint32_t i, int destination = -1);
+    // Compile le noeud i, une expression ; si destination >= 0, le résultat est rangé dans ce registre
+    void compilerCondition(uint32_t i, bool sautSiVrai, vector<size_t> & sauts);
+    // Compile le test de la condition i et des sauts pris si elle vaut sautSiVrai ; ajoute à sauts les numéros
+    //  des instructions de saut à corriger (aucun si la condition est constante et ne saute jamais)
+    void affecter(uint32_t i, Operande valeur); // Compile l'affectation de valeur à la variable du noeud i
+    void lireVariable(unsigned int variable); // VERIFIER si la variable n'est pas sûrement définie
+    void definirVariable(unsigned int variable); // DEFINIR si la variable n'est pas sûrement définie
+};
+
+#endif /* MACHINEVIRTUELLE_H */
@@ -0,0 +1,210 @@
+#include "Operations.h"
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <class Suite>
+static Noeud* avecVariable(Noeud * noeud, Suite suite) {
+  // Forme d'opérande d'une variable : lue avec ou sans vérification
+  NoeudVariable * variable = (NoeudVariable *) noeud;
+  if (variable->estSpecialise()) // NoeudVariableDefinie
+    return suite(OperandeVariableDefinie{&variable->getCadre(), variable->getCase()});
+  return suite(OperandeVariable{&variable->getCadre(), variable->getCase()});
+}
+
+template <class Gauche, class Creer>
+static Noeud* avecDroit(Gauche gauche, Noeud * droit, Creer creer) {
+  // Choix de la forme de l'opérande droit
+  if (estVariable(droit)) return avecVariable(droit, [gauche, &creer](auto od) { return creer(gauche, od); });
+  if (droit->getGenre() == Genre::ENTIER)
+    return creer(gauche, OperandeConstante{((NoeudEntier *) droit)->getValeur()});
+  return creer(gauche, OperandeNoeud{droit});
+}
+
+template <class Creer>
+static Noeud* avecOperandes(Noeud * gauche, Noeud * droit, Creer creer, Noeud * sinon) {
+  // Choix de la forme de l'opérande gauche ; creer(gauche, droit) crée le noeud spécialisé pour ces formes
+  if (estVariable(gauche)) return avecVariable(gauche, [droit, &creer](auto og) { return avecDroit(og, droit, creer); });
+  if (gauche->getGenre() == Genre::ENTIER)
+    return avecDroit(OperandeConstante{((NoeudEntier *) gauche)->getValeur()}, droit, creer);
+  if (estVariable(droit) || droit->getGenre() == Genre::ENTIER)
+    return avecDroit(OperandeNoeud{gauche}, droit, creer);
+  return sinon; // deux opérandes quelconques : l'aiguillage de NoeudOperateurBinaire::executer suffit
+}
+
+template <class Creer>
+static Noeud* avecDiviseurNonNul(Noeud * gauche, Noeud * droit, Creer creer, Noeud * sinon) {
+  // Comme avecOperandes, le diviseur prenant la forme OperandeNonNul : une instanciation par forme, pour la division seule
+  return avecOperandes(gauche, droit, [&creer](auto og, auto od) { return creer(og, OperandeNonNul<decltype(od)>{od}); }, sinon);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Noeud* specialiserOperation(NoeudOperateurBinaire * operation, Noeud * gauche, Noeud * droit, Arene & arene,
+        bool diviseurNonNul) {
+  // Une instanciation de NoeudOperation par opérateur et par forme d'opérandes
+  if (diviseurNonNul && operation->getOperateur().getCode() == S_DIVISE)
+    return avecDiviseurNonNul(gauche, droit, [operation, &arene](auto og, auto od) -> Noeud* {
+      return arene.creer<NoeudOperation<S_DIVISE, decltype(og), decltype(od)>>(*operation, og, od);
+    }, operation);
+  return avecOperandes(gauche, droit, [operation, &arene](auto og, auto od) -> Noeud* {
+    switch (operation->getOperateur().getCode()) {
+#define X(nom) case S_##nom: return arene.creer<NoeudOperation<S_##nom, decltype(og), decltype(od)>>(*operation, og, od);
+        OPERATEURS_BINAIRES(X)
+#undef X
+      default: return operation;
+    }
+  }, operation);
+}
+
+Noeud* specialiserAffectation(NoeudAffectation * affectation, Arene & arene, bool diviseurNonNul) {
+  // Seulement les opérations arithmétiques : une comparaison affectée à une variable est rare
+  Noeud * variable = affectation->getVariable();
+  NoeudOperateurBinaire * operation = enOperation(affectation->getExpression());
+  if (!estVariable(variable) || operation == nullptr) return affectation;
+  Cadre * cadre = &((NoeudVariable *) variable)->getCadre();
+  unsigned int numeroCase = ((NoeudVariable *) variable)->getCase();
+  if (diviseurNonNul && operation->getOperateur().getCode() == S_DIVISE)
+    return avecDiviseurNonNul(operation->getOperandeGauche(), operation->getOperandeDroit(),
+            [affectation, cadre, numeroCase, &arene](auto og, auto od) -> Noeud* {
+      return arene.creer<NoeudAffectationOperation<S_DIVISE, decltype(og), decltype(od)>>(*affectation, cadre, numeroCase, og, od);
+    }, affectation);
+  return avecOperandes(operation->getOperandeGauche(), operation->getOperandeDroit(),
+          [affectation, cadre, numeroCase, operation, &arene](auto og, auto od) -> Noeud* {
+    switch (operation->getOperateur().getCode()) {
+#define X(nom) case S_##nom: \
+        return arene.creer<NoeudAffectationOperation<S_##nom, decltype(og), decltype(od)>>(*affectation, cadre, numeroCase, og, od);
+        X(PLUS) X(MOINS) X(MULTIPLIE) X(DIVISE)
+#undef X
+      default: return affectation;
+    }
+  }, affectation);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <template <class> class Specialisee, class Instruction, class Gauche, class Droit>
+static Noeud* comparer(Instruction * instruction, CodeSymbole comparaison, Gauche gauche, Droit droit, Noeud * generale, Arene & arene) {
+  // Une instanciation par comparaison
+  switch (comparaison) {
+#define X(nom) case S_##nom: \
+      return arene.creer<Specialisee<Comparaison<S_##nom, Gauche, Droit>>>(*instruction, Comparaison<S_##nom, Gauche, Droit>{gauche, droit});
+      COMPARAISONS(X)
+#undef X
+    default: return generale;
+  }
+}
+
+template <template <class> class Specialisee, class Instruction>
+static Noeud* specialiser(Instruction * instruction, Noeud * condition, Arene & arene) {
+  // Seulement une variable comparée à une variable ou à une constante (les autres formes sont rares dans
+  //  une condition de boucle ou de si) ; une instruction déjà spécialisée est recopiée : sa condition a pu
+  //  changer depuis
+  Noeud * generale = !instruction->estSpecialise() ? instruction : arene.creer<Instruction>(*instruction);
+  NoeudOperateurBinaire * operation = enOperation(condition);
+  if (operation == nullptr || !estVariable(operation->getOperandeGauche())) return generale;
+  CodeSymbole comparaison = operation->getOperateur().getCode();
+  Noeud * droit = operation->getOperandeDroit();
+  if (!estVariable(droit) && droit->getGenre() != Genre::ENTIER) return generale;
+  return avecVariable(operation->getOperandeGauche(), [instruction, comparaison, droit, generale, &arene](auto gauche) {
+    if (estVariable(droit))
+      return avecVariable(droit, [instruction, comparaison, gauche, generale, &arene](auto od) {
+        return comparer<Specialisee>(instruction, comparaison, gauche, od, generale, arene);
+      });
+    return comparer<Specialisee>(instruction, comparaison, gauche, OperandeConstante{((NoeudEntier *) droit)->getValeur()}, generale, arene);
+  });
+}
+
+Noeud* specialiserBoucle(NoeudInstTantQue * boucle, Arene & arene) {
+  return specialiser<NoeudTantQueSpecialise>(boucle, boucle->getCondition(), arene);
+}
+
+Noeud* specialiserBoucle(NoeudInstRepeter * boucle, Arene & arene) {
+  return specialiser<NoeudRepeterSpecialise>(boucle, boucle->getCondition(), arene);
+}
+
+Noeud* specialiserBoucle(NoeudInstPour * boucle, Arene & arene) {
+  return specialiser<NoeudPourSpecialise>(boucle, boucle->getCondition(), arene);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+NoeudInstSelon::NoeudInstSelon(const NoeudInstSiRiche & si, NoeudVariable * variable, const vector<NoeudEntier*> & cles,
+        const vector<Noeud*> & sequences, Noeud * sinon)
+: NoeudInstSiRiche(si), m_variable(variable), m_cles(cles), m_sequences(sequences), m_sinon(sinon), m_minimum(0), m_table(),
+m_triees() {
+  m_specialise = true;
+  for (uint32_t i = 0; i < m_cles.size(); i++) m_triees.push_back({m_cles[i]->getValeur(), i});
+  sort(m_triees.begin(), m_triees.end());
+  int64_t etendue = (int64_t) m_triees.back().first - m_triees.front().first + 1;
+  if (etendue <= 4 * (int64_t) m_triees.size()) { // assez dense : une case par valeur
+    m_minimum = m_triees.front().first;
+    m_table.assign(etendue, AUCUNE);
+    for (const pair<int, uint32_t> & cle : m_triees) m_table[(int64_t) cle.first - m_minimum] = cle.second;
+    m_triees.clear();
+  }
+}
+
+int NoeudInstSelon::executer() {
+  int valeur = m_variable->executer(); // exception si elle n'est pas définie, comme à la première condition
+  uint32_t branche = AUCUNE;
+  if (!m_table.empty()) {
+    uint64_t rang = (uint64_t) ((int64_t) valeur - m_minimum);
+    if (rang < m_table.size()) branche = m_table[rang];
+  } else {
+    auto cle = lower_bound(m_triees.begin(), m_triees.end(), pair<int, uint32_t>(valeur, 0));
+    if (cle != m_triees.end() && cle->first == valeur) branche = cle->second;
+  }
+  if (branche != AUCUNE) m_sequences[branche]->executer();
+  else if (m_sinon != nullptr) m_sinon->executer();
+  return 0;
+}
+
+void NoeudInstSelon::traduitEnCPP(ostream & cout, unsigned int indentation) const {
+  cout << setw(4 * indentation) << "" << "switch (";
+  m_variable->traduitEnCPP(cout, 0);
+  cout << ") {" << endl;
+  for (size_t i = 0; i < m_cles.size(); i++) {
+    cout << setw(4 * (indentation + 1)) << "" << "case ";
+    m_cles[i]->traduitEnCPP(cout, 0);
+    cout << ": {" << endl;
+    m_sequences[i]->traduitEnCPP(cout, indentation + 2);
+    cout << setw(4 * (indentation + 1)) << "" << "} break;" << endl;
+  }
+  if (m_sinon != nullptr) {
+    cout << setw(4 * (indentation + 1)) << "" << "default: {" << endl;
+    m_sinon->traduitEnCPP(cout, indentation + 2);
+    cout << setw(4 * (indentation + 1)) << "" << "}" << endl;
+  }
+  cout << setw(4 * indentation) << "" << "}";
+}
+
+Noeud* specialiserSiRiche(NoeudInstSiRiche * si, Arene & arene) {
+  // Un si riche déjà spécialisé est recopié : ses conditions ont pu changer depuis
+  vector<Noeud*> fils;
+  si->parcourirFils([&fils](Noeud * f) { fils.push_back(f); });
+  size_t nbBranches = fils.size() / 2;
+  if (nbBranches == 1) return specialiser<NoeudSiSpecialise>(si, fils[0], arene);
+  Noeud * generale = !si->estSpecialise() ? si : arene.creer<NoeudInstSiRiche>(*si);
+  if (nbBranches < NoeudInstSelon::BRANCHES_MIN) return generale;
+  NoeudVariable * variable = nullptr;
+  vector<NoeudEntier*> cles;
+  vector<Noeud*> sequences;
+  for (size_t i = 0; i < nbBranches; i++) {
+    NoeudOperateurBinaire * egalite = enOperation(fils[2 * i]);
+    if (egalite == nullptr || egalite->getOperateur().getCode() != S_EGAL) return generale;
+    Noeud * gauche = egalite->getOperandeGauche(), * droit = egalite->getOperandeDroit();
+    if (gauche->getGenre() == Genre::ENTIER) swap(gauche, droit); // 1 == op comme op == 1
+    if (!estVariable(gauche) || droit->getGenre() != Genre::ENTIER) return generale;
+    if (variable == nullptr) variable = (NoeudVariable *) gauche;
+    else if (((NoeudVariable *) gauche)->getCase() != variable->getCase()) return generale;
+    cles.push_back((NoeudEntier *) droit);
+    sequences.push_back(fils[2 * i + 1]);
+  }
+  vector<int> valeurs;
+  for (NoeudEntier * cle : cles) valeurs.push_back(cle->getValeur());
+  sort(valeurs.begin(), valeurs.end());
+  if (adjacent_find(valeurs.begin(), valeurs.end()) != valeurs.end()) return generale; // un switch n'a pas deux fois le même cas
+  Noeud * sinon = (fils.size() % 2) ? fils.back() : nullptr;
+  return arene.creer<NoeudInstSelon>(*si, variable, cles, sequences, sinon);
+}
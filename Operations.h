@@ -0,0 +1,311 @@
+#ifndef OPERATIONS_H
+#define OPERATIONS_H
+
+#include "ArbreAbstrait.h"
+#include "Arene.h"
+#include "Cadre.h"
+#include "Exceptions.h"
+#include "Symbole.h"
+
+// Calcul des opérateurs du langage, aiguillé sur le code de l'opérateur (résolu une fois pour toutes
+// à la lecture), et noeuds d'opération spécialisés selon l'opérateur et la forme des opérandes.
+// +, - et * calculent modulo 2^32 (débordement sans comportement indéfini), et / aussi : le plus petit
+// entier divisé par -1 vaut lui-même (comme son opposé), au lieu d'arrêter le programme (SIGFPE).
+
+// Opérateurs binaires (X(nom) pour S_nom), pour générer un cas par opérateur dans les moteurs d'exécution
+//  (et et ou, évalués paresseusement, n'en font pas partie : voir NoeudOperateurLogique)
+#define OPERATEURS_BINAIRES(X) \
+    X(PLUS) X(MOINS) X(MULTIPLIE) X(DIVISE) X(EGAL) X(DIFFERENT) \
+    X(INFERIEUR) X(INFERIEUREGAL) X(SUPERIEUR) X(SUPERIEUREGAL)
+
+// Les opérateurs binaires qui sont des comparaisons
+#define COMPARAISONS(X) \
+    X(EGAL) X(DIFFERENT) X(INFERIEUR) X(INFERIEUREGAL) X(SUPERIEUR) X(SUPERIEUREGAL)
+
+inline int diviser(int og, int od) {
+    return od == -1 ? (int) (0u - (unsigned int) og) : og / od;
+} // og / od, od étant non nul ; modulo 2^32 (voir CodeNatif::calculer et CompilateurCPP)
+
+inline int calculer(CodeSymbole operateur, int og, int od) {
+    switch (operateur) {
+        case S_PLUS: return (int) ((unsigned int) og + (unsigned int) od);
+        case S_MOINS: return (int) ((unsigned int) og - (unsigned int) od);
+        case S_MULTIPLIE: return (int) ((unsigned int) og * (unsigned int) od);
+        case S_DIVISE:
+            if (od == 0) throw DivParZeroException();
+            return diviser(og, od);
+        case S_EGAL: return og == od;
+        case S_DIFFERENT: return og != od;
+        case S_INFERIEUR: return og < od;
+        case S_INFERIEUREGAL: return og <= od;
+        case S_SUPERIEUR: return og > od;
+        case S_SUPERIEUREGAL: return og >= od;
+        default: return 0;
+    }
+} // Valeur de og operateur od
+
+inline int calculerUnaire(CodeSymbole operateur, int operande) {
+    switch (operateur) {
+        case S_NON: return !operande;
+        case S_MOINS: return (int) (0u - (unsigned int) operande);
+        default: return 0;
+    }
+} // Valeur de operateur operande (non ou moins unaire)
+
+inline const char * operateurCPP(CodeSymbole operateur) {
+    switch (operateur) {
+        case S_ET: return "&&";
+        case S_OU: return "||";
+        case S_NON: return "!";
+        default: return Symbole::getNom(operateur); // les autres s'écrivent comme en C++
+    }
+} // Opérateur C++ qui traduit operateur
+
+// Formes d'opérande : chacune sait obtenir sa valeur sans passer par un appel virtuel, sauf la forme générale
+
+struct OperandeVariable {
+    const Cadre * cadre;
+    unsigned int numeroCase;
+
+    inline int valeur() const {
+        return cadre->getValeur(numeroCase);
+    }
+}; // Une variable résolue : lecture directe de sa case
+
+struct OperandeVariableDefinie {
+    const Cadre * cadre;
+    unsigned int numeroCase;
+
+    inline int valeur() const {
+        return cadre->getValeurDefinie(numeroCase);
+    }
+}; // Une variable sûrement définie (voir NoeudVariableDefinie) : lecture de sa case sans vérification
+
+struct OperandeConstante {
+    int constante;
+
+    inline int valeur() const {
+        return constante;
+    }
+}; // Un entier littéral : valeur immédiate
+
+struct OperandeNoeud {
+    Noeud * noeud;
+
+    inline int valeur() const {
+        return noeud->executer();
+    }
+}; // Un noeud quelconque : évaluation par son executer
+
+template <class Forme>
+struct OperandeNonNul {
+    Forme forme;
+
+    inline int valeur() const {
+        return forme.valeur();
+    }
+}; // Un diviseur dont l'optimiseur a prouvé qu'il n'est jamais nul (voir Optimiseur::diviseurNonNul)
+
+template <CodeSymbole OPERATEUR, class Droit>
+inline int appliquer(int og, const Droit & droit) {
+    return calculer(OPERATEUR, og, droit.valeur());
+} // Valeur de og OPERATEUR droit
+
+template <CodeSymbole OPERATEUR, class Forme>
+inline int appliquer(int og, const OperandeNonNul<Forme> & droit) {
+    if (OPERATEUR == S_DIVISE) return diviser(og, droit.valeur()); // sans vérifier que le diviseur est non nul
+    return calculer(OPERATEUR, og, droit.valeur());
+} // Valeur de og OPERATEUR droit
+
+////////////////////////////////////////////////////////////////////////////////
+template <CodeSymbole OPERATEUR, class Gauche, class Droit>
+class NoeudOperation final : public NoeudOperateurBinaire {
+// Classe pour représenter une opération binaire dont l'opérateur et la forme des opérandes sont connus
+//  à la compilation : l'évaluation se réduit à un appel virtuel, sans aiguillage ni comparaison de chaînes.
+//  Le noeud garde ses fils (traduction, aplatissement) : seule l'exécution est spécialisée.
+  public:
+    NoeudOperation(const NoeudOperateurBinaire & operation, Gauche gauche, Droit droit)
+    : NoeudOperateurBinaire(operation), m_gauche(gauche), m_droit(droit) {
+        m_specialise = true;
+    }
+
+    int executer() override {
+        int og = m_gauche.valeur();
+        return appliquer<OPERATEUR>(og, m_droit);
+    } // l'opérande gauche est évalué avant le droit, comme dans NoeudOperateurBinaire
+
+  private:
+    Gauche m_gauche;
+    Droit  m_droit;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+template <CodeSymbole OPERATEUR, class Gauche, class Droit>
+class NoeudAffectationOperation final : public NoeudAffectation {
+// Superinstruction : affectation à une variable d'une opération spécialisée (x = x + c, x = y * z...).
+//  Un seul appel virtuel au lieu de trois (affectation, opération, écriture de la variable) ; comme
+//  NoeudOperation, le noeud garde ses fils et seule l'exécution est spécialisée.
+  public:
+    NoeudAffectationOperation(const NoeudAffectation & affectation, Cadre * cadre, unsigned int numeroCase, Gauche gauche, Droit droit)
+    : NoeudAffectation(affectation), m_cadre(cadre), m_case(numeroCase), m_gauche(gauche), m_droit(droit) {
+        m_specialise = true;
+    }
+
+    int executer() override {
+        int og = m_gauche.valeur();
+        m_cadre->setValeur(m_case, appliquer<OPERATEUR>(og, m_droit));
+        return 0;
+    } // évalue l'opération, puis range sa valeur dans la case de la variable
+
+  private:
+    Cadre * m_cadre;
+    unsigned int m_case;
+    Gauche m_gauche;
+    Droit  m_droit;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Boucles et si dont la condition compare deux variables, ou une variable et une constante : la comparaison
+//  est faite dans le noeud, sans appel virtuel, et les instructions de leur séquence sont exécutées
+//  directement (les fils sont gardés, seule l'exécution est spécialisée)
+
+template <CodeSymbole COMPARAISON, class Gauche, class Droit>
+struct Comparaison {
+    Gauche gauche;
+    Droit droit;
+
+    inline int valeur() const {
+        int og = gauche.valeur();
+        return calculer(COMPARAISON, og, droit.valeur());
+    }
+}; // La condition d'une boucle ou d'un si spécialisé
+
+inline void executerCorps(Noeud * corps) {
+    if (corps->getGenre() != Genre::SEQUENCE) {
+        corps->executer();
+        return;
+    }
+    for (Noeud * instruction : ((NoeudSeqInst *) corps)->getInstructions()) instruction->executer();
+} // Exécute corps, sans l'appel de NoeudSeqInst::executer si c'est une séquence
+
+template <class Condition>
+class NoeudTantQueSpecialise final : public NoeudInstTantQue {
+  public:
+    NoeudTantQueSpecialise(const NoeudInstTantQue & boucle, Condition condition)
+    : NoeudInstTantQue(boucle), m_test(condition) {
+        m_specialise = true;
+    }
+
+    int executer() override {
+        while (m_test.valeur()) executerCorps(m_sequence);
+        return 0;
+    }
+
+  private:
+    Condition m_test;
+};
+
+template <class Condition>
+class NoeudRepeterSpecialise final : public NoeudInstRepeter {
+  public:
+    NoeudRepeterSpecialise(const NoeudInstRepeter & boucle, Condition condition)
+    : NoeudInstRepeter(boucle), m_test(condition) {
+        m_specialise = true;
+    }
+
+    int executer() override {
+        do {
+            executerCorps(m_sequence);
+        } while (!m_test.valeur());
+        return 0;
+    }
+
+  private:
+    Condition m_test;
+};
+
+template <class Condition>
+class NoeudPourSpecialise final : public NoeudInstPour {
+  public:
+    NoeudPourSpecialise(const NoeudInstPour & boucle, Condition condition)
+    : NoeudInstPour(boucle), m_test(condition) {
+        m_specialise = true;
+    }
+
+    int executer() override {
+        if (m_affecter != nullptr) m_affecter->executer();
+        while (m_test.valeur()) {
+            executerCorps(m_sequence);
+            if (m_action != nullptr) m_action->executer();
+        }
+        return 0;
+    }
+
+  private:
+    Condition m_test;
+};
+
+template <class Condition>
+class NoeudSiSpecialise final : public NoeudInstSiRiche {
+  public:
+    NoeudSiSpecialise(const NoeudInstSiRiche & si, Condition condition)
+    : NoeudInstSiRiche(si), m_test(condition) {
+        m_specialise = true;
+    }
+
+    int executer() override {
+        if (m_test.valeur()) executerCorps(m_vecteurConditonInstruction[1]);
+        else if (m_vecteurConditonInstruction.size() == 3) executerCorps(m_vecteurConditonInstruction[2]);
+        return 0;
+    } // une seule condition, et peut-être un sinon
+
+  private:
+    Condition m_test;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class NoeudInstSelon final : public NoeudInstSiRiche {
+// Classe pour représenter un si riche dont chaque condition compare la même variable à un entier littéral,
+//  tous différents (si (op == 1) ... sinonsi (op == 2) ...) : la branche est choisie d'après la valeur de la
+//  variable, dans une table qu'elle indice si les entiers sont proches, par recherche dichotomique sinon, au
+//  lieu d'évaluer les conditions une à une. Le noeud garde ses fils (aplatissement, optimisation) ; il se
+//  traduit par un switch.
+  public:
+    static constexpr size_t BRANCHES_MIN = 3; // En dessous, évaluer les conditions coûte moins que chercher
+
+    NoeudInstSelon(const NoeudInstSiRiche & si, NoeudVariable * variable, const vector<NoeudEntier*> & cles,
+            const vector<Noeud*> & sequences, Noeud * sinon);
+    // Construit le choix de la séquence sequences[i] quand variable vaut cles[i] (sinon, s'il y en a un)
+    int executer() override; // Exécute la séquence de la branche dont l'entier est la valeur de la variable
+    void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const override;
+
+  private:
+    static constexpr uint32_t AUCUNE = UINT32_MAX; // Pas de branche pour cette valeur
+
+    NoeudVariable * m_variable; // La variable comparée
+    vector<NoeudEntier*> m_cles; // L'entier de chaque branche, dans l'ordre du si riche
+    vector<Noeud*> m_sequences; // La séquence de chaque branche
+    Noeud * m_sinon; // La séquence du sinon, ou nullptr
+    int m_minimum; // Table dense : la plus petite clé...
+    vector<uint32_t> m_table; //  ... et la branche de chaque valeur à partir d'elle (vide si la table est clairsemée)
+    vector<pair<int, uint32_t> > m_triees; // Table clairsemée : (clé, branche), triées par clé
+};
+
+Noeud* specialiserOperation(NoeudOperateurBinaire * operation, Noeud * gauche, Noeud * droit, Arene & arene,
+        bool diviseurNonNul = false);
+// Renvoie un NoeudOperation créé dans arene qui remplace operation (d'opérandes résolus gauche et droit),
+//  ou operation elle-même si elle n'a pas de forme spécialisée (non, deux opérandes quelconques) ; une
+//  division dont le diviseur est sûrement non nul ne le vérifie pas
+Noeud* specialiserAffectation(NoeudAffectation * affectation, Arene & arene, bool diviseurNonNul = false);
+// Renvoie la superinstruction créée dans arene qui remplace affectation (une variable = une opération
+//  arithmétique spécialisable), ou affectation elle-même
+Noeud* specialiserBoucle(NoeudInstTantQue * boucle, Arene & arene);
+Noeud* specialiserBoucle(NoeudInstRepeter * boucle, Arene & arene);
+Noeud* specialiserBoucle(NoeudInstPour * boucle, Arene & arene);
+// Renvoie la forme spécialisée de boucle pour sa condition actuelle, créée dans arene ; si la condition
+//  n'est pas une comparaison de variables et de constantes, une boucle de la forme générale
+Noeud* specialiserSiRiche(NoeudInstSiRiche * si, Arene & arene);
+// Renvoie le NoeudInstSelon qui remplace si (d'après ses conditions actuelles), créé dans arene, ou sa
+//  forme spécialisée s'il n'a qu'une condition, ou un si riche de la forme générale
+
+#endif /* OPERATIONS_H */
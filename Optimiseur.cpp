@@ -0,0 +1,873 @@
+#include "Optimiseur.h"
+#include "Operations.h"
+#include "Visiteur.h"
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+using namespace std;
+
+// Nom de chaque transformation, dans l'ordre de l'énumération Transformation
+static const char * const NOMS_TRANSFORMATIONS[Optimiseur::NB_TRANSFORMATIONS] = {
+  "constantes pliées", "identités", "doubles négations", "branches supprimées", "invariants sortis des boucles",
+  "affectations mortes supprimées", "boucles candidates au calcul sans itérer", "lectures sans vérification",
+  "divisions sans vérification", "comparaisons décidées par les intervalles",
+  "sous-expressions communes réutilisées"
+};
+
+// Ensembles de variables, indicés par le numéro de case (les temporaires ajoutent des cases en cours de route)
+
+static inline bool contient(const vector<bool> & variables, unsigned int i) {
+  return i < variables.size() && variables[i];
+}
+
+static inline void marquer(vector<bool> & variables, unsigned int i, bool valeur = true) {
+  if (i >= variables.size()) variables.resize(i + 1);
+  variables[i] = valeur;
+}
+
+static inline bool estAffectation(const Noeud* noeud) {
+  return noeud->getGenre() == Genre::AFFECTATION; // ou l'une de ses formes spécialisées
+}
+
+static void marquerEcrites(const Noeud* noeud, vector<bool> & ecrites) {
+  // Variables que noeud (une instruction) peut affecter
+  if (estAffectation(noeud)) {
+    const Noeud * variable = ((const NoeudAffectation *) noeud)->getVariable();
+    if (estVariable(variable)) marquer(ecrites, ((const NoeudVariable *) variable)->getCase());
+  } else if (noeud->getGenre() == Genre::LIRE) {
+    parcourirFils(noeud, [&ecrites](Noeud * variable) {
+      if (estVariable(variable)) marquer(ecrites, ((NoeudVariable *) variable)->getCase());
+    });
+  } else
+    parcourirFils(noeud, [&ecrites](Noeud * fils) { marquerEcrites(fils, ecrites); });
+}
+
+static void marquerLues(const Noeud* noeud, vector<bool> & lues, bool valeur) {
+  // Marque (ou démarque) dans lues les variables dont noeud peut lire la valeur
+  if (estVariable(noeud)) marquer(lues, ((const NoeudVariable *) noeud)->getCase(), valeur);
+  else if (estAffectation(noeud)) marquerLues(((const NoeudAffectation *) noeud)->getExpression(), lues, valeur);
+  else if (noeud->getGenre() != Genre::LIRE) // lire affecte ses variables sans les lire
+    parcourirFils(noeud, [&lues, valeur](Noeud * fils) { marquerLues(fils, lues, valeur); });
+}
+
+static unsigned int compterNoeuds(const Noeud* noeud) {
+  // Nombre de noeuds de l'arbre de racine noeud (pour les statistiques) ; une boucle calculée compte pour un,
+  //  comme dans l'arbre aplati : la boucle d'origine n'est exécutée que si elle ne peut pas être calculée
+  unsigned int nb = 1;
+  if (noeud->getGenre() != Genre::BOUCLE_CALCULEE) parcourirFils(noeud, [&nb](Noeud * fils) { nb += compterNoeuds(fils); });
+  return nb;
+}
+
+static bool litUneDe(const Noeud* expression, const vector<bool> & variables) {
+  // indique si expression lit l'une des variables
+  if (estVariable(expression)) return contient(variables, ((const NoeudVariable *) expression)->getCase());
+  bool lit = false;
+  parcourirFils(expression, [&lit, &variables](Noeud * fils) { lit = lit || litUneDe(fils, variables); });
+  return lit;
+}
+
+class Surete : public Visiteur<Surete, bool> {
+// Une variable peut être indéfinie, une chaîne n'a pas de valeur : seuls les calculs sur des constantes
+//  et des variables sûrement définies sont sûrs (ne peuvent pas lever d'exception)
+public:
+  Surete(const vector<bool> & definies) : m_definies(definies) {
+  }
+
+  bool visiterNoeudEntier(NoeudEntier *) {
+    return true;
+  }
+
+  bool visiterNoeudVariable(NoeudVariable * variable) {
+    return contient(m_definies, variable->getCase());
+  }
+
+  bool visiterNoeudOperateurUnaire(NoeudOperateurUnaire * unaire) {
+    return visiter(unaire->getOperande());
+  }
+
+  bool visiterNoeudOperateurLogique(NoeudOperateurLogique * logique) {
+    return visiter(logique->getOperandeGauche()) && visiter(logique->getOperandeDroit());
+  }
+
+  bool visiterNoeudOperateurBinaire(NoeudOperateurBinaire * operation) {
+    int valeur;
+    if (!visiter(operation->getOperandeGauche()) || !visiter(operation->getOperandeDroit())) return false;
+    return operation->getOperateur().getCode() != S_DIVISE // diviseur littéral non nul
+            || (Optimiseur::estConstante(operation->getOperandeDroit(), valeur) && valeur != 0);
+  }
+
+  bool visiterAutre(Noeud *) {
+    return false;
+  }
+
+private:
+  const vector<bool> & m_definies; // Les variables sûrement définies
+};
+
+static inline bool estSure(Noeud* noeud, const vector<bool> & definies) {
+  return Surete(definies).visiter(noeud);
+}
+
+class Affinite : public Visiteur<Affinite, bool> {
+// Une expression est une combinaison affine des variables si elle n'est faite que d'entiers, de variables, de moins
+//  unaires, de + et de -, et de * dont les coefficients ne lisent aucune d'elles
+public:
+  Affinite(const vector<bool> & variables) : m_variables(variables) {
+  }
+
+  bool visiterNoeudEntier(NoeudEntier *) {
+    return true;
+  }
+
+  bool visiterNoeudVariable(NoeudVariable *) {
+    return true;
+  }
+
+  bool visiterNoeudOperateurUnaire(NoeudOperateurUnaire * unaire) {
+    return unaire->getOperateur().getCode() == S_MOINS && visiter(unaire->getOperande());
+  }
+
+  bool visiterNoeudOperateurBinaire(NoeudOperateurBinaire * operation) {
+    Noeud * gauche = operation->getOperandeGauche(), * droit = operation->getOperandeDroit();
+    if (!visiter(gauche) || !visiter(droit)) return false;
+    switch (operation->getOperateur().getCode()) {
+      case S_PLUS: case S_MOINS: return true;
+      case S_MULTIPLIE: return !litUneDe(gauche, m_variables) || !litUneDe(droit, m_variables);
+      default: return false;
+    }
+  }
+
+  bool visiterAutre(Noeud *) {
+    return false;
+  }
+
+private:
+  const vector<bool> & m_variables; // Les variables de la boucle
+};
+
+static inline bool estAffine(Noeud* expression, const vector<bool> & variables) {
+  return Affinite(variables).visiter(expression);
+}
+
+// Intervalles de valeurs
+
+static const Optimiseur::Intervalle TOUT = {INT32_MIN, INT32_MAX}; // Aucune information
+
+static inline Optimiseur::Intervalle calcule(int64_t min, int64_t max) {
+  // Un calcul qui sort des entiers a débordé (l'arithmétique est modulo 2^32) : son résultat peut valoir n'importe quoi
+  if (min < INT32_MIN || max > INT32_MAX) return TOUT;
+  return {min, max};
+}
+
+static bool decider(CodeSymbole comparaison, const Optimiseur::Intervalle & g, const Optimiseur::Intervalle & d, int & valeur) {
+  // indique si la comparaison d'une valeur de g à une valeur de d a toujours le même résultat, valeur
+  bool vraie, fausse;
+  switch (comparaison) {
+    case S_INFERIEUR: vraie = g.max < d.min; fausse = g.min >= d.max; break;
+    case S_INFERIEUREGAL: vraie = g.max <= d.min; fausse = g.min > d.max; break;
+    case S_SUPERIEUR: vraie = g.min > d.max; fausse = g.max <= d.min; break;
+    case S_SUPERIEUREGAL: vraie = g.min >= d.max; fausse = g.max < d.min; break;
+    case S_EGAL: case S_DIFFERENT:
+      vraie = g.min == g.max && d.min == d.max && g.min == d.min;
+      fausse = g.max < d.min || d.max < g.min;
+      if (comparaison == S_DIFFERENT) swap(vraie, fausse);
+      break;
+    default: return false;
+  }
+  valeur = vraie;
+  return vraie || fausse;
+}
+
+static CodeSymbole inverse(CodeSymbole comparaison) {
+  // a comparaison b équivaut à b inverse(comparaison) a
+  switch (comparaison) {
+    case S_INFERIEUR: return S_SUPERIEUR;
+    case S_INFERIEUREGAL: return S_SUPERIEUREGAL;
+    case S_SUPERIEUR: return S_INFERIEUR;
+    case S_SUPERIEUREGAL: return S_INFERIEUREGAL;
+    default: return comparaison; // == et !=
+  }
+}
+
+static string texte(const Optimiseur::Intervalle & intervalle) {
+  return "[" + to_string(intervalle.min) + ", " + to_string(intervalle.max) + "]";
+}
+
+static string texte(CodeSymbole operateur, Noeud* gauche, Noeud* droit) {
+  ostringstream sortie;
+  sortie << "(";
+  gauche->traduitEnCPP(sortie, 0);
+  sortie << " " << operateurCPP(operateur) << " ";
+  droit->traduitEnCPP(sortie, 0);
+  sortie << ")";
+  return sortie.str();
+}
+
+static inline bool estOperation(Noeud* noeud) {
+  Genre genre = noeud->getGenre();
+  return genre == Genre::OPERATION || genre == Genre::LOGIQUE || genre == Genre::UNAIRE;
+}
+
+static bool egales(Noeud* a, Noeud* b) {
+  // indique si les expressions a et b ont la même structure (les formes spécialisées d'une opération, ou les
+  //  lectures d'une variable avec ou sans vérification, sont égales entre elles)
+  if (a == b) return true;
+  if (a->getGenre() != b->getGenre()) return false;
+  switch (a->getGenre()) {
+    case Genre::ENTIER: return ((NoeudEntier *) a)->getValeur() == ((NoeudEntier *) b)->getValeur();
+    case Genre::VARIABLE: return ((NoeudVariable *) a)->getCase() == ((NoeudVariable *) b)->getCase();
+    case Genre::UNAIRE: {
+      NoeudOperateurUnaire * ua = (NoeudOperateurUnaire *) a, * ub = (NoeudOperateurUnaire *) b;
+      return ua->getOperateur().getCode() == ub->getOperateur().getCode() && egales(ua->getOperande(), ub->getOperande());
+    }
+    case Genre::LOGIQUE: {
+      NoeudOperateurLogique * la = (NoeudOperateurLogique *) a, * lb = (NoeudOperateurLogique *) b;
+      return la->getOperateur().getCode() == lb->getOperateur().getCode()
+              && egales(la->getOperandeGauche(), lb->getOperandeGauche()) && egales(la->getOperandeDroit(), lb->getOperandeDroit());
+    }
+    case Genre::OPERATION: {
+      NoeudOperateurBinaire * oa = (NoeudOperateurBinaire *) a, * ob = (NoeudOperateurBinaire *) b;
+      return oa->getOperateur().getCode() == ob->getOperateur().getCode()
+              && egales(oa->getOperandeGauche(), ob->getOperandeGauche()) && egales(oa->getOperandeDroit(), ob->getOperandeDroit());
+    }
+    default: return false;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Optimiseur::Optimiseur(Cadre & cadre, Arene & arene)
+: m_cadre(cadre), m_arene(arene), m_definies(), m_peutEtreDefinies(), m_lectures(), m_indefinies(), m_intervalles(),
+m_verifications(), m_boucles(), m_nbTemporaires(0), m_compteurs(), m_noeudsAvant(0), m_noeudsApres(0) {
+}
+
+Noeud* Optimiseur::optimiser(Noeud* arbre) {
+  m_noeudsAvant = compterNoeuds(arbre);
+  m_definies.assign(m_cadre.getTaille(), false);
+  for (unsigned int i = 0; i < m_cadre.getTaille(); i++) m_definies[i] = m_cadre.estDefini(i);
+  m_peutEtreDefinies = m_definies;
+  m_intervalles.assign(m_cadre.getTaille(), TOUT);
+  for (unsigned int i = 0; i < m_cadre.getTaille(); i++)
+    if (m_definies[i]) m_intervalles[i] = {m_cadre.getValeurDefinie(i), m_cadre.getValeurDefinie(i)};
+  arbre = optimiserFils(arbre);
+  m_noeudsApres = compterNoeuds(arbre);
+  return arbre;
+}
+
+class Optimisation : public Visiteur<Optimisation, Noeud*> {
+// La méthode optimiser de chaque classe qui en a une ; les feuilles et les boucles déjà calculées restent telles quelles
+public:
+  Optimisation(Optimiseur & optimiseur) : m_optimiseur(optimiseur) {
+  }
+
+#define OPTIMISER(classe) \
+  Noeud* visiter##classe(classe * noeud) { \
+    return noeud->optimiser(m_optimiseur); \
+  }
+  OPTIMISER(NoeudSeqInst) OPTIMISER(NoeudAffectation) OPTIMISER(NoeudOperateurBinaire) OPTIMISER(NoeudOperateurLogique)
+  OPTIMISER(NoeudOperateurUnaire) OPTIMISER(NoeudInstSi) OPTIMISER(NoeudInstTantQue) OPTIMISER(NoeudInstRepeter)
+  OPTIMISER(NoeudInstPour) OPTIMISER(NoeudInstEcrire) OPTIMISER(NoeudInstSiRiche) OPTIMISER(NoeudInstLire)
+  OPTIMISER(NoeudVariable)
+#undef OPTIMISER
+
+  Noeud* visiterAutre(Noeud * noeud) {
+    return noeud;
+  }
+
+private:
+  Optimiseur & m_optimiseur;
+};
+
+Noeud* Optimiseur::optimiserFils(Noeud* noeud) {
+  return Optimisation(*this).visiter(noeud);
+}
+
+ostream & operator<<(ostream & cout, const Optimiseur & optimiseur) {
+  for (unsigned int i = 0; i < Optimiseur::NB_TRANSFORMATIONS; i++)
+    cout << endl << "  " << NOMS_TRANSFORMATIONS[i] << " : " << optimiseur.m_compteurs[i];
+  // les temporaires des invariants ajoutent des noeuds : le nombre de noeuds supprimés peut être négatif
+  cout << endl << "  noeuds supprimés : " << (int) (optimiseur.m_noeudsAvant - optimiseur.m_noeudsApres)
+          << " (" << optimiseur.m_noeudsAvant << " -> " << optimiseur.m_noeudsApres << ")" << endl;
+  for (const string & verification : optimiseur.m_verifications) cout << "  " << verification << endl;
+  return cout;
+}
+
+void Optimiseur::avertir(ostream & sortie) const {
+  for (unsigned int numeroCase : m_indefinies)
+    sortie << "Attention : la variable " << m_cadre.getNom(numeroCase) << " est lue sans pouvoir être définie" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Noeud* Optimiseur::operation(const Symbole & operateur, Noeud* gauche, Noeud* droit) {
+  NoeudOperateurBinaire* operation = m_arene.creer<NoeudOperateurBinaire>(operateur, gauche, droit);
+  return specialiserOperation(operation, gauche, droit, m_arene, diviseurNonNul(operateur.getCode(), droit));
+}
+
+Noeud* Optimiseur::affectation(Noeud* variable, Noeud* expression) {
+  NoeudOperateurBinaire * operation = enOperation(expression);
+  bool nonNul = operation != nullptr && diviseurNonNul(operation->getOperateur().getCode(), operation->getOperandeDroit());
+  return specialiserAffectation(m_arene.creer<NoeudAffectation>(variable, expression), m_arene, nonNul);
+}
+
+Noeud* Optimiseur::entier(int valeur) {
+  return m_arene.creer<NoeudEntier>(valeur);
+}
+
+Noeud* Optimiseur::sequenceVide() {
+  return m_arene.creer<NoeudSeqInst>();
+}
+
+bool Optimiseur::estConstante(Noeud* noeud, int & valeur) {
+  if (noeud->getGenre() != Genre::ENTIER) return false;
+  valeur = ((NoeudEntier *) noeud)->getValeur();
+  return true;
+}
+
+bool Optimiseur::estBooleen(Noeud* noeud) {
+  switch (noeud->getGenre()) {
+    case Genre::ENTIER: return ((NoeudEntier *) noeud)->getValeur() == 0 || ((NoeudEntier *) noeud)->getValeur() == 1;
+    case Genre::LOGIQUE: return true;
+    case Genre::UNAIRE: return ((NoeudOperateurUnaire *) noeud)->getOperateur().getCode() == S_NON;
+    case Genre::OPERATION:
+      switch (((NoeudOperateurBinaire *) noeud)->getOperateur().getCode()) {
+#define X(nom) case S_##nom: return true;
+          COMPARAISONS(X)
+#undef X
+        default: return false;
+      }
+    default: return false;
+  }
+}
+
+bool Optimiseur::estSur(Noeud* noeud) const {
+  return estSure(noeud, m_definies);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Noeud* Optimiseur::simplifierOperation(CodeSymbole operateur, Noeud* gauche, Noeud* droit) {
+  int og = 0, od = 0;
+  bool constanteGauche = estConstante(gauche, og), constanteDroit = estConstante(droit, od);
+  if (constanteGauche && constanteDroit) {
+    if (operateur == S_DIVISE && od == 0)
+      return nullptr; // l'erreur se produira à l'exécution, comme sans optimisation
+    compter(CONSTANTES_PLIEES);
+    return entier(calculer(operateur, og, od));
+  }
+  Intervalle ig = intervalle(gauche), id = intervalle(droit);
+  int valeur;
+  if (decider(operateur, ig, id, valeur) && estSur(gauche) && estSur(droit)) { // sans lecture qui pourrait échouer
+    noter(COMPARAISONS_DECIDEES, "comparaison décidée : " + texte(operateur, gauche, droit) + " vaut " + to_string(valeur)
+            + ", opérandes dans " + texte(ig) + " et " + texte(id));
+    return entier(valeur);
+  }
+  Noeud* resultat = nullptr;
+  switch (operateur) {
+    case S_PLUS:
+      if (constanteDroit && od == 0) resultat = gauche; // x + 0
+      else if (constanteGauche && og == 0) resultat = droit; // 0 + x
+      break;
+    case S_MOINS:
+      if (constanteDroit && od == 0) resultat = gauche; // x - 0
+      break;
+    case S_MULTIPLIE:
+      if (constanteDroit && od == 1) resultat = gauche; // x * 1
+      else if (constanteGauche && og == 1) resultat = droit; // 1 * x
+      else if ((constanteDroit && od == 0 && estSur(gauche)) || (constanteGauche && og == 0 && estSur(droit)))
+        resultat = entier(0); // x * 0, si l'évaluation de x ne peut pas échouer
+      break;
+    case S_DIVISE:
+      if (constanteDroit && od == 1) resultat = gauche; // x / 1
+      else if (diviseurNonNul(operateur, droit)) // l'opération sera recréée sans vérification (voir operation)
+        noter(DIVISIONS_SANS_VERIFICATION, "division sans vérification : " + texte(operateur, gauche, droit)
+              + ", diviseur dans " + texte(id));
+      break;
+    default:
+      break;
+  }
+  if (resultat != nullptr) compter(IDENTITES);
+  return resultat;
+}
+
+Noeud* Optimiseur::simplifierLogique(CodeSymbole operateur, Noeud* gauche, Noeud* droit) {
+  // a et b vaut 0 si a est faux, (b != 0) sinon ; a ou b vaut 1 si a est vrai, (b != 0) sinon
+  int og = 0, od = 0;
+  bool decisif = (operateur == S_OU); // valeur de vérité de l'opérande gauche qui décide seule du résultat
+  if (estConstante(gauche, og)) {
+    if ((og != 0) == decisif) {
+      compter(CONSTANTES_PLIEES); // l'opérande droit n'était pas évalué : on le supprime
+      return entier(decisif);
+    }
+    if (estConstante(droit, od)) {
+      compter(CONSTANTES_PLIEES);
+      return entier(od != 0);
+    }
+    if (estBooleen(droit)) {
+      compter(IDENTITES);
+      return droit;
+    }
+    return nullptr;
+  }
+  if (estConstante(droit, od)) {
+    if ((od != 0) != decisif && estBooleen(gauche)) { // x et 1, x ou 0
+      compter(IDENTITES);
+      return gauche;
+    }
+    if ((od != 0) == decisif && estSur(gauche)) { // x et 0, x ou 1
+      compter(IDENTITES);
+      return entier(decisif);
+    }
+  }
+  return nullptr;
+}
+
+Noeud* Optimiseur::simplifierUnaire(CodeSymbole operateur, Noeud* operande) {
+  int valeur;
+  if (estConstante(operande, valeur)) {
+    compter(CONSTANTES_PLIEES);
+    return entier(calculerUnaire(operateur, valeur));
+  }
+  if (operande->getGenre() != Genre::UNAIRE) return nullptr;
+  NoeudOperateurUnaire * interieur = (NoeudOperateurUnaire *) operande;
+  if (interieur->getOperateur().getCode() != operateur) return nullptr;
+  // - - x vaut x ; non non x aussi, mais seulement si x vaut déjà 0 ou 1
+  if (operateur == S_MOINS || estBooleen(interieur->getOperande())) {
+    compter(DOUBLES_NEGATIONS);
+    return interieur->getOperande();
+  }
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Ce que l'on sait des variables. L'optimiseur sait quelles variables sont sûrement définies au point du
+// parcours où il est (une variable définie le reste) : leur lecture se fait sans vérification (voir lire et
+// NoeudVariableDefinie), et une expression qui ne lit qu'elles et ne divise que par des constantes non
+// nulles ne peut pas échouer (voir estSur). Il sait aussi lesquelles peuvent avoir été définies : la lecture
+// d'une variable qui ne peut pas l'être échouera sûrement, et fait l'objet d'un avertissement (voir avertir).
+// Il borne enfin chaque variable par un intervalle : les affectations le calculent à partir des littéraux,
+// les conditions des si et des boucles le restreignent (supposer), et le compteur d'une boucle pour ne
+// repasse pas sous sa valeur de départ (bornerCompteur). Une division dont le diviseur ne peut pas être nul
+// ne le vérifie plus, et une comparaison dont les intervalles décident du résultat est pliée.
+
+void Optimiseur::definir(const Noeud* variable, Noeud* valeur) {
+  if (!estVariable(variable)) return;
+  unsigned int numeroCase = ((const NoeudVariable *) variable)->getCase();
+  borner(numeroCase, valeur != nullptr ? intervalle(valeur) : TOUT); // valeur est calculée avant l'affectation
+  marquer(m_definies, numeroCase);
+  marquer(m_peutEtreDefinies, numeroCase);
+}
+
+void Optimiseur::supposer(Noeud* condition) {
+  // Seulement les comparaisons d'une variable, éventuellement reliées par des et : la variable est bornée
+  //  par l'intervalle de l'autre opérande
+  if (condition->getGenre() == Genre::LOGIQUE) {
+    NoeudOperateurLogique * logique = (NoeudOperateurLogique *) condition;
+    if (logique->getOperateur().getCode() != S_ET) return;
+    supposer(logique->getOperandeGauche());
+    supposer(logique->getOperandeDroit());
+    return;
+  }
+  NoeudOperateurBinaire * comparaison = enOperation(condition);
+  if (comparaison == nullptr) return;
+  CodeSymbole code = comparaison->getOperateur().getCode();
+  Noeud * gauche = comparaison->getOperandeGauche(), * droit = comparaison->getOperandeDroit();
+  if (!estVariable(gauche)) { // 3 < x comme x > 3
+    swap(gauche, droit);
+    code = inverse(code);
+  }
+  if (!estVariable(gauche)) return;
+  Intervalle variable = intervalle(gauche), autre = intervalle(droit);
+  switch (code) {
+    case S_INFERIEUR: variable.max = min(variable.max, autre.max - 1); break;
+    case S_INFERIEUREGAL: variable.max = min(variable.max, autre.max); break;
+    case S_SUPERIEUR: variable.min = max(variable.min, autre.min + 1); break;
+    case S_SUPERIEUREGAL: variable.min = max(variable.min, autre.min); break;
+    case S_EGAL:
+      variable = {max(variable.min, autre.min), min(variable.max, autre.max)};
+      break;
+    case S_DIFFERENT: // seule une borne peut être exclue
+      if (autre.min == autre.max && variable.min == autre.min) variable.min++;
+      else if (autre.min == autre.max && variable.max == autre.max) variable.max--;
+      break;
+    default: return;
+  }
+  if (variable.min <= variable.max) borner(((NoeudVariable *) gauche)->getCase(), variable); // sinon, code jamais exécuté
+}
+
+void Optimiseur::bornerCompteur(Noeud* sequence, Noeud* action) {
+  // Un compteur que seule l'action change, d'un pas fixe, et qui ne déborde pas (la condition, voir supposer,
+  //  le borne assez loin de la limite des entiers) ne repasse pas sous sa valeur de départ (au-dessus, s'il recule)
+  if (action == nullptr || !estAffectation(action)) return;
+  NoeudAffectation * affectation = (NoeudAffectation *) action;
+  NoeudOperateurBinaire * pas = enOperation(affectation->getExpression());
+  int valeur;
+  if (!estVariable(affectation->getVariable()) || pas == nullptr || !estVariable(pas->getOperandeGauche())
+          || !estConstante(pas->getOperandeDroit(), valeur)) return;
+  unsigned int compteur = ((NoeudVariable *) affectation->getVariable())->getCase();
+  vector<bool> ecrites;
+  marquerEcrites(sequence, ecrites);
+  if (((NoeudVariable *) pas->getOperandeGauche())->getCase() != compteur || contient(ecrites, compteur)) return;
+  int64_t avance = pas->getOperateur().getCode() == S_PLUS ? valeur : pas->getOperateur().getCode() == S_MOINS ? -(int64_t) valeur : 0;
+  const vector<Intervalle> & avant = m_boucles.back().intervalles;
+  Intervalle depart = compteur < avant.size() ? avant[compteur] : TOUT, courant = intervalle(affectation->getVariable());
+  if (avance > 0 && courant.max + avance <= INT32_MAX) courant.min = max(courant.min, depart.min);
+  else if (avance < 0 && courant.min + avance >= INT32_MIN) courant.max = min(courant.max, depart.max);
+  if (courant.min <= courant.max) borner(compteur, courant);
+}
+
+void Optimiseur::restreindre(Etat & communes) const {
+  for (unsigned int i = 0; i < communes.definies.size(); i++) communes.definies[i] = communes.definies[i] && contient(m_definies, i);
+  for (unsigned int i = 0; i < communes.intervalles.size(); i++) {
+    Intervalle ici = i < m_intervalles.size() ? m_intervalles[i] : TOUT;
+    communes.intervalles[i] = {min(communes.intervalles[i].min, ici.min), max(communes.intervalles[i].max, ici.max)};
+  }
+}
+
+class Intervalles : public Visiteur<Intervalles, Optimiseur::Intervalle> {
+// L'intervalle des valeurs d'une expression, d'après ceux des variables
+public:
+  typedef Optimiseur::Intervalle Intervalle;
+
+  Intervalles(const vector<Intervalle> & variables) : m_variables(variables) {
+  }
+
+  Intervalle visiterNoeudEntier(NoeudEntier * entier) {
+    return {entier->getValeur(), entier->getValeur()};
+  }
+
+  Intervalle visiterNoeudVariable(NoeudVariable * variable) {
+    return variable->getCase() < m_variables.size() ? m_variables[variable->getCase()] : TOUT;
+  }
+
+  Intervalle visiterNoeudOperateurLogique(NoeudOperateurLogique *) {
+    return {0, 1};
+  }
+
+  Intervalle visiterNoeudOperateurUnaire(NoeudOperateurUnaire * unaire) {
+    Intervalle operande = visiter(unaire->getOperande());
+    if (unaire->getOperateur().getCode() == S_MOINS) return calcule(-operande.max, -operande.min);
+    if (operande.min > 0 || operande.max < 0) return {0, 0}; // non d'une valeur jamais nulle
+    return operande.min == 0 && operande.max == 0 ? Intervalle{1, 1} : Intervalle{0, 1};
+  }
+
+  Intervalle visiterNoeudOperateurBinaire(NoeudOperateurBinaire * operation) {
+    Intervalle g = visiter(operation->getOperandeGauche()), d = visiter(operation->getOperandeDroit());
+    CodeSymbole operateur = operation->getOperateur().getCode();
+    int valeur;
+    switch (operateur) {
+      case S_PLUS: return calcule(g.min + d.min, g.max + d.max);
+      case S_MOINS: return calcule(g.min - d.max, g.max - d.min);
+      case S_MULTIPLIE: case S_DIVISE: {
+        if (operateur == S_DIVISE && d.min <= 0 && d.max >= 0) return TOUT;
+        // les extrêmes sont atteints aux bornes (pour la division, le diviseur ne change pas de signe)
+        int64_t coins[4] = {g.min * d.min, g.min * d.max, g.max * d.min, g.max * d.max};
+        if (operateur == S_DIVISE) coins[0] = g.min / d.min, coins[1] = g.min / d.max, coins[2] = g.max / d.min, coins[3] = g.max / d.max;
+        return calcule(*min_element(coins, coins + 4), *max_element(coins, coins + 4));
+      }
+      default: // une comparaison
+        return decider(operateur, g, d, valeur) ? Intervalle{valeur, valeur} : Intervalle{0, 1};
+    }
+  }
+
+  Intervalle visiterAutre(Noeud *) {
+    return TOUT;
+  }
+
+private:
+  const vector<Intervalle> & m_variables; // L'intervalle de chaque variable, indicé par sa case
+};
+
+Optimiseur::Intervalle Optimiseur::intervalle(Noeud* expression) const {
+  return Intervalles(m_intervalles).visiter(expression);
+}
+
+bool Optimiseur::diviseurNonNul(CodeSymbole operateur, Noeud* droit) const {
+  if (operateur != S_DIVISE) return false;
+  Intervalle diviseur = intervalle(droit);
+  return diviseur.min > 0 || diviseur.max < 0;
+}
+
+void Optimiseur::borner(unsigned int numeroCase, Intervalle intervalle) {
+  if (numeroCase >= m_intervalles.size()) m_intervalles.resize(numeroCase + 1, TOUT);
+  m_intervalles[numeroCase] = intervalle;
+}
+
+void Optimiseur::noter(Transformation transformation, const string & description) {
+  compter(transformation);
+  m_verifications.push_back(description);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Invariants de boucle : une expression sûre qui ne lit aucune variable écrite dans une boucle est calculée
+// une fois avant la boucle, dans une variable temporaire (une case du cadre qui n'est pas dans la table des
+// symboles). Les affectations des temporaires sont insérées avant la boucle par sortirBoucle.
+
+void Optimiseur::entrerBoucle(const Noeud* boucle) {
+  m_boucles.push_back(Boucle{vector<bool>(m_cadre.getTaille()), m_definies, m_intervalles, {}});
+  marquerEcrites(boucle, m_boucles.back().ecrites);
+  // un tour peut lire ce qu'a écrit le tour précédent : ce qui est écrit peut valoir n'importe quoi
+  const vector<bool> & ecrites = m_boucles.back().ecrites;
+  for (unsigned int i = 0; i < ecrites.size(); i++)
+    if (ecrites[i]) {
+      marquer(m_peutEtreDefinies, i);
+      borner(i, TOUT);
+    }
+}
+
+Noeud* Optimiseur::lire(NoeudVariable* variable) {
+  unsigned int numeroCase = variable->getCase();
+  if (!contient(m_definies, numeroCase)) {
+    if (!contient(m_peutEtreDefinies, numeroCase) && find(m_indefinies.begin(), m_indefinies.end(), numeroCase) == m_indefinies.end())
+      m_indefinies.push_back(numeroCase); // l'exécution de cette lecture lèvera sûrement une exception
+    return variable;
+  }
+  if (numeroCase >= m_lectures.size()) m_lectures.resize(numeroCase + 1, nullptr);
+  if (m_lectures[numeroCase] == nullptr) m_lectures[numeroCase] = m_arene.creer<NoeudVariableDefinie>(m_cadre, numeroCase);
+  compter(LECTURES_SANS_VERIFICATION);
+  return m_lectures[numeroCase];
+}
+
+Noeud* Optimiseur::sortirBoucle(Noeud* boucle) {
+  vector<Noeud*> invariants = move(m_boucles.back().invariants);
+  m_boucles.pop_back();
+  if (invariants.empty()) return boucle;
+  NoeudSeqInst* sequence = m_arene.creer<NoeudSeqInst>(); // insérée à la place de la boucle par la séquence qui la contient
+  for (Noeud* affectation : invariants) sequence->ajoute(affectation);
+  sequence->ajoute(boucle);
+  return sequence;
+}
+
+// Boucles calculées : une boucle dont le compteur avance d'un pas fixe vers une borne, et dont le corps ne
+// fait que des affectations affines (les accumulations de sommes, de produits par une constante...), est
+// remplacée par un NoeudBoucleCalculee, qui calcule son effet sans itérer quand le nombre d'itérations est
+// exact (et l'itère sinon).
+
+Noeud* Optimiseur::calculerBoucle(Noeud* boucle, Noeud* affecter, Noeud* condition, Noeud* sequence, Noeud* action) {
+  // Une itération : la séquence, puis l'action, qui ne doivent être que des affectations de variables
+  if (sequence->getGenre() != Genre::SEQUENCE) return nullptr;
+  vector<Noeud*> instructions;
+  parcourirFils(sequence, [&instructions](Noeud * instruction) { instructions.push_back(instruction); });
+  if (action != nullptr) instructions.push_back(action);
+  Recurrence recurrence;
+  vector<bool> variables;
+  for (Noeud* instruction : instructions) {
+    if (!estAffectation(instruction)) return nullptr;
+    NoeudAffectation * affectation = (NoeudAffectation *) instruction;
+    if (!estVariable(affectation->getVariable())) return nullptr;
+    marquer(variables, ((NoeudVariable *) affectation->getVariable())->getCase());
+    recurrence.iteration.push_back(affectation);
+  }
+  for (NoeudAffectation* affectation : recurrence.iteration)
+    if (!estAffine(affectation->getExpression(), variables)) return nullptr;
+  // La condition : compteur (affecté dans la boucle) comparé à une borne (qui ne l'est pas), dans un sens ou l'autre
+  NoeudOperateurBinaire * comparaison = enOperation(condition);
+  if (comparaison == nullptr) return nullptr;
+  Noeud * compteur = comparaison->getOperandeGauche(), * borne = comparaison->getOperandeDroit();
+  CodeSymbole operateur = comparaison->getOperateur().getCode();
+  if (!estVariable(compteur) || !litUneDe(compteur, variables)) {
+    swap(compteur, borne); // borne < compteur équivaut à compteur > borne...
+    if (operateur == S_INFERIEUR) operateur = S_SUPERIEUR;
+    else if (operateur == S_INFERIEUREGAL) operateur = S_SUPERIEUREGAL;
+    else if (operateur == S_SUPERIEUR) operateur = S_INFERIEUR;
+    else if (operateur == S_SUPERIEUREGAL) operateur = S_INFERIEUREGAL;
+  }
+  if (!estVariable(compteur) || !litUneDe(compteur, variables)) return nullptr;
+  if ((!estVariable(borne) && borne->getGenre() != Genre::ENTIER) || litUneDe(borne, variables))
+    return nullptr;
+  if (operateur != S_INFERIEUR && operateur != S_INFERIEUREGAL && operateur != S_SUPERIEUR && operateur != S_SUPERIEUREGAL)
+    return nullptr;
+  recurrence.compteur = ((NoeudVariable *) compteur)->getCase();
+  recurrence.comparaison = operateur;
+  recurrence.borne = borne;
+  // Les variables lues avant d'être affectées (dans la condition, puis dans l'itération) doivent être définies
+  vector<bool> entree, affectees;
+  auto lire = [&entree, &affectees](Noeud * expression) {
+    vector<bool> lues;
+    marquerLues(expression, lues, true);
+    for (unsigned int i = 0; i < lues.size(); i++)
+      if (lues[i] && !contient(affectees, i)) marquer(entree, i);
+  };
+  lire(condition);
+  for (NoeudAffectation* affectation : recurrence.iteration) {
+    lire(affectation->getExpression());
+    marquer(affectees, ((NoeudVariable *) affectation->getVariable())->getCase());
+  }
+  for (unsigned int i = 0; i < variables.size(); i++)
+    if (variables[i]) recurrence.variables.push_back(i);
+  for (unsigned int i = 0; i < entree.size(); i++)
+    if (entree[i]) recurrence.entree.push_back(i);
+  compter(BOUCLES_CANDIDATES); // calculées à l'exécution seulement si le compteur avance d'un pas fixe
+  return m_arene.creer<NoeudBoucleCalculee>(boucle, affecter, condition, sequence, action, m_cadre, recurrence);
+}
+
+Noeud* Optimiseur::optimiserExpression(Noeud* expression) {
+  expression = optimiserFils(expression);
+  return m_boucles.empty() ? expression : sortirInvariants(expression);
+}
+
+Noeud* Optimiseur::sortirInvariants(Noeud* expression) {
+  if (!estOperation(expression)) return expression; // une feuille se lit aussi vite qu'un temporaire
+  // La boucle la plus externe dont l'expression est invariante, et avant laquelle elle ne peut pas échouer
+  //  (une boucle contient les suivantes : ce qui est invariant dans l'une l'est dans celles qu'elle contient)
+  for (Boucle & boucle : m_boucles) {
+    if (litUneDe(expression, boucle.ecrites) || !estSure(expression, boucle.definies)) continue;
+    string * nom = m_arene.creer<string>("_invariant" + to_string(++m_nbTemporaires)); // pas un nom du langage
+    NoeudVariable * temporaire = m_arene.creer<NoeudVariable>(m_cadre, m_cadre.ajouterCase(*nom));
+    boucle.invariants.push_back(affectation(temporaire, expression));
+    definir(temporaire, expression);
+    compter(INVARIANTS_SORTIS);
+    return lire(temporaire); // calculé avant la boucle : toujours défini
+  }
+  // Sinon, on cherche dans les opérandes ; l'expression est reconstruite si l'un d'eux change
+  if (expression->getGenre() == Genre::UNAIRE) {
+    NoeudOperateurUnaire * unaire = (NoeudOperateurUnaire *) expression;
+    Noeud * operande = sortirInvariants(unaire->getOperande());
+    if (operande == unaire->getOperande()) return expression;
+    return m_arene.creer<NoeudOperateurUnaire>(unaire->getOperateur(), operande);
+  }
+  if (expression->getGenre() == Genre::LOGIQUE) {
+    NoeudOperateurLogique * logique = (NoeudOperateurLogique *) expression;
+    Noeud * gauche = sortirInvariants(logique->getOperandeGauche());
+    Noeud * droit = sortirInvariants(logique->getOperandeDroit());
+    if (gauche == logique->getOperandeGauche() && droit == logique->getOperandeDroit()) return expression;
+    return m_arene.creer<NoeudOperateurLogique>(logique->getOperateur(), gauche, droit);
+  }
+  NoeudOperateurBinaire * binaire = (NoeudOperateurBinaire *) expression;
+  Noeud * gauche = sortirInvariants(binaire->getOperandeGauche());
+  Noeud * droit = sortirInvariants(binaire->getOperandeDroit());
+  if (gauche == binaire->getOperandeGauche() && droit == binaire->getOperandeDroit()) return expression;
+  return operation(binaire->getOperateur(), gauche, droit);
+}
+
+// Affectations mortes : dans une séquence, une affectation sûre dont la variable est réaffectée sans avoir
+// été lue entre temps est supprimée ; ni ecrire ni la table des symboles finale n'en dépendent.
+
+void Optimiseur::eliminerAffectationsMortes(vector<Noeud*> & instructions, const vector<bool> & sures) {
+  // Parcours à rebours : ecrasees contient les variables qui seront réaffectées plus loin sans avoir été lues
+  //  (si le programme s'arrête sur une erreur entre temps, la table des symboles finale n'est pas affichée)
+  vector<bool> ecrasees(m_cadre.getTaille());
+  vector<Noeud*> gardees;
+  for (size_t i = instructions.size(); i-- > 0;) {
+    Noeud * instruction = instructions[i];
+    if (estAffectation(instruction)) {
+      const Noeud * variable = ((NoeudAffectation *) instruction)->getVariable();
+      if (estVariable(variable)) {
+        unsigned int numeroCase = ((const NoeudVariable *) variable)->getCase();
+        if (sures[i] && contient(ecrasees, numeroCase)) {
+          compter(AFFECTATIONS_MORTES);
+          continue;
+        }
+        marquer(ecrasees, numeroCase); // l'expression est évaluée avant l'affectation : ses lectures démarquent
+      }
+    } else if (instruction->getGenre() == Genre::LIRE)
+      marquerEcrites(instruction, ecrasees);
+    marquerLues(instruction, ecrasees, false); // une écriture conditionnelle (si, boucle) ne démarque ni ne marque
+    gardees.push_back(instruction);
+  }
+  instructions.assign(gardees.rbegin(), gardees.rend());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Sous-expressions communes : dans une suite d'affectations, une opération sûre qu'une affectation
+// précédente a déjà calculée, sans que ses variables aient changé depuis, n'est calculée qu'une fois, dans
+// une variable temporaire que les deux affectations lisent.
+
+void Optimiseur::partagerCommunes(vector<Noeud*> & instructions, vector<bool> & sures, vector<Disponible> & disponibles) {
+  Noeud * derniere = instructions.back();
+  if (!estAffectation(derniere) || !estVariable(((NoeudAffectation *) derniere)->getVariable())) {
+    if (derniere->getGenre() != Genre::ECRIRE) disponibles.clear(); // ecrire n'affecte rien
+    return;
+  }
+  NoeudAffectation * affectation = (NoeudAffectation *) derniere;
+  Noeud * expression = partager(affectation->getExpression(), instructions, sures, disponibles);
+  if (expression != affectation->getExpression()) // sans diviseur non nul : l'état est celui d'après l'affectation
+    instructions.back() = specialiserAffectation(m_arene.creer<NoeudAffectation>(affectation->getVariable(), expression), m_arene);
+  // ses valeurs sont calculées avant que sa variable ne change : celles qui la lisent ne sont plus disponibles
+  vector<bool> ecrite;
+  marquer(ecrite, ((NoeudVariable *) affectation->getVariable())->getCase());
+  disponibles.erase(remove_if(disponibles.begin(), disponibles.end(),
+          [&ecrite](const Disponible & disponible) { return litUneDe(disponible.expression, ecrite); }), disponibles.end());
+  rendreDisponibles(expression, instructions.size() - 1, ecrite, disponibles);
+}
+
+Noeud* Optimiseur::partager(Noeud* expression, vector<Noeud*> & instructions, vector<bool> & sures, vector<Disponible> & disponibles) {
+  if (!estOperation(expression)) return expression;
+  auto disponible = find_if(disponibles.begin(), disponibles.end(),
+          [expression](const Disponible & d) { return egales(d.expression, expression); });
+  if (disponible == disponibles.end()) {
+    // sinon ses opérandes : l'opération dont un opérande est devenu un temporaire peut encore être disponible
+    Noeud * nouvelle = reconstruire(expression, [this, &instructions, &sures, &disponibles](Noeud * operande) {
+      return partager(operande, instructions, sures, disponibles);
+    });
+    if (nouvelle == expression) return expression;
+    expression = nouvelle;
+    disponible = find_if(disponibles.begin(), disponibles.end(),
+            [expression](const Disponible & d) { return egales(d.expression, expression); });
+    if (disponible == disponibles.end()) return expression;
+  }
+  compter(SOUS_EXPRESSIONS_COMMUNES);
+  if (disponible->temporaire != nullptr) return disponible->temporaire;
+  // Deuxième occurrence : la valeur est calculée dans un temporaire, juste avant la première affectation qui l'utilise
+  string * nom = m_arene.creer<string>("_commun" + to_string(++m_nbTemporaires)); // pas un nom du langage
+  NoeudVariable * temporaire = m_arene.creer<NoeudVariable>(m_cadre, m_cadre.ajouterCase(*nom));
+  definir(temporaire);
+  Noeud * valeur = disponible->expression, * lecture = lire(temporaire);
+  size_t rang = disponible->instruction;
+  disponible->temporaire = lecture;
+  for (Disponible & d : disponibles)
+    if (d.instruction >= rang) d.instruction++;
+  instructions.insert(instructions.begin() + rang, affectation(temporaire, valeur));
+  sures.insert(sures.begin() + rang, false);
+  NoeudAffectation * premiere = (NoeudAffectation *) instructions[rang + 1];
+  function<Noeud*(Noeud*)> remplacer = [&remplacer, this, valeur, lecture](Noeud * operande) {
+    return egales(operande, valeur) ? lecture : reconstruire(operande, remplacer);
+  };
+  Noeud * nouvelle = remplacer(premiere->getExpression());
+  instructions[rang + 1] = specialiserAffectation(m_arene.creer<NoeudAffectation>(premiere->getVariable(), nouvelle), m_arene);
+  // Les autres valeurs de la première affectation sont celles de sa nouvelle expression (les opérations qui
+  //  contenaient celle-ci lisent maintenant le temporaire) et, calculées par le temporaire, les opérandes de
+  //  celle-ci, si leurs variables n'ont pas changé depuis
+  disponibles.erase(remove_if(disponibles.begin(), disponibles.end(), [rang](const Disponible & d) {
+    return d.instruction == rang + 1 && d.temporaire == nullptr;
+  }), disponibles.end());
+  vector<bool> ecrites;
+  for (size_t i = rang + 1; i + 1 < instructions.size(); i++) marquerEcrites(instructions[i], ecrites);
+  rendreDisponibles(nouvelle, rang + 1, ecrites, disponibles);
+  parcourirFils(valeur, [this, rang, &ecrites, &disponibles](Noeud * operande) {
+    rendreDisponibles(operande, rang, ecrites, disponibles);
+  });
+  return lecture;
+}
+
+void Optimiseur::rendreDisponibles(Noeud* expression, size_t instruction, const vector<bool> & ecrites,
+        vector<Disponible> & disponibles) const {
+  if (!estOperation(expression)) return;
+  if (estSur(expression) && !litUneDe(expression, ecrites)) disponibles.push_back(Disponible{expression, instruction, nullptr});
+  parcourirFils(expression, [this, instruction, &ecrites, &disponibles](Noeud * operande) {
+    rendreDisponibles(operande, instruction, ecrites, disponibles);
+  });
+}
+
+Noeud* Optimiseur::reconstruire(Noeud* expression, const function<Noeud*(Noeud*)> & transformer) {
+  // Une opération binaire reconstruite ne garde pas un diviseur non nul : l'état n'est plus celui où elle est évaluée
+  if (expression->getGenre() == Genre::UNAIRE) {
+    NoeudOperateurUnaire * unaire = (NoeudOperateurUnaire *) expression;
+    Noeud * operande = transformer(unaire->getOperande());
+    if (operande == unaire->getOperande()) return expression;
+    return m_arene.creer<NoeudOperateurUnaire>(unaire->getOperateur(), operande);
+  }
+  if (expression->getGenre() == Genre::LOGIQUE) {
+    NoeudOperateurLogique * logique = (NoeudOperateurLogique *) expression;
+    Noeud * gauche = transformer(logique->getOperandeGauche());
+    Noeud * droit = transformer(logique->getOperandeDroit());
+    if (gauche == logique->getOperandeGauche() && droit == logique->getOperandeDroit()) return expression;
+    return m_arene.creer<NoeudOperateurLogique>(logique->getOperateur(), gauche, droit);
+  }
+  NoeudOperateurBinaire * binaire = enOperation(expression);
+  if (binaire == nullptr) return expression; // une feuille
+  Noeud * gauche = transformer(binaire->getOperandeGauche());
+  Noeud * droit = transformer(binaire->getOperandeDroit());
+  if (gauche == binaire->getOperandeGauche() && droit == binaire->getOperandeDroit()) return expression;
+  return specialiserOperation(m_arene.creer<NoeudOperateurBinaire>(binaire->getOperateur(), gauche, droit), gauche, droit, m_arene);
+}
@@ -0,0 +1,148 @@
+#ifndef OPTIMISEUR_H
+#define OPTIMISEUR_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "ArbreAbstrait.h"
+#include "Arene.h"
+#include "Cadre.h"
+
+// Optimiseur simplifie l'arbre abstrait résolu, avant son exécution (option -O) : chaque noeud
+// s'optimise après ses fils (voir optimiserFils) et renvoie le noeud qui le remplace. Une expression
+// n'est jamais modifiée en place : si ses opérandes changent, c'est un nouveau noeud qui la remplace.
+// Les simplifications gardent la sémantique de l'interpréteur, erreurs comprises : une division par un
+// zéro littéral, ou la lecture d'une variable peut-être indéfinie, restent dans l'arbre et lèvent leur
+// exception à l'exécution. Les noeuds créés le sont dans l'arène de l'interpréteur.
+// Au fil du parcours, l'optimiseur suit ce qu'il sait des variables (définies, intervalles de valeurs),
+// sort les invariants des boucles, calcule certaines boucles sans les itérer, et supprime affectations
+// mortes et calculs répétés : chaque passe est décrite avec son code, dans Optimiseur.cpp.
+
+class Optimiseur {
+public:
+    // Transformations comptées par les statistiques (option -stats)
+    enum Transformation {
+        CONSTANTES_PLIEES, IDENTITES, DOUBLES_NEGATIONS, BRANCHES_SUPPRIMEES, INVARIANTS_SORTIS, AFFECTATIONS_MORTES,
+        BOUCLES_CANDIDATES, LECTURES_SANS_VERIFICATION, DIVISIONS_SANS_VERIFICATION, COMPARAISONS_DECIDEES,
+        SOUS_EXPRESSIONS_COMMUNES, NB_TRANSFORMATIONS
+    };
+
+    struct Intervalle {
+        int64_t min, max;
+    }; // Les valeurs que peut prendre une expression, bornes comprises
+
+    struct Etat {
+        vector<bool> definies; // Les variables sûrement définies
+        vector<Intervalle> intervalles; // Les valeurs possibles de chaque variable, si elle est définie
+    }; // Ce que l'optimiseur sait des variables en un point du parcours
+
+    struct Disponible {
+        Noeud* expression; // Une opération sûre calculée par une affectation de la séquence
+        size_t instruction; // Le rang de cette affectation dans la séquence
+        Noeud* temporaire; // La lecture du temporaire qui garde sa valeur, une fois qu'elle est partagée
+    }; // Une valeur que les instructions suivantes de la séquence peuvent réutiliser
+
+    Optimiseur(Cadre & cadre, Arene & arene); // Optimiseur des arbres dont les variables sont dans cadre
+    Noeud* optimiser(Noeud* arbre); // Optimise l'arbre et renvoie sa nouvelle racine
+    Noeud* optimiserFils(Noeud* noeud);
+    // Appelle la méthode optimiser de la classe de noeud (aiguillée sur son genre, voir Visiteur.h), qui optimise
+    //  ses fils et renvoie le noeud qui le remplace dans l'arbre (lui-même s'il n'y a rien à simplifier)
+
+    // Simplifications appelées par les noeuds, une fois leurs fils optimisés :
+    //  renvoient le noeud qui remplace l'opération, ou nullptr s'il n'y a rien à simplifier
+    Noeud* simplifierOperation(CodeSymbole operateur, Noeud* gauche, Noeud* droit);
+    Noeud* simplifierLogique(CodeSymbole operateur, Noeud* gauche, Noeud* droit);
+    Noeud* simplifierUnaire(CodeSymbole operateur, Noeud* operande);
+
+    Noeud* optimiserExpression(Noeud* expression);
+    // Optimise une expression d'instruction, puis, dans une boucle, en sort les sous-expressions invariantes
+    void eliminerAffectationsMortes(vector<Noeud*> & instructions, const vector<bool> & sures);
+    // Supprime d'une séquence les affectations sures[i] dont la valeur est écrasée avant d'être lue
+    void partagerCommunes(vector<Noeud*> & instructions, vector<bool> & sures, vector<Disponible> & disponibles);
+    // La dernière instruction de la séquence vient d'être optimisée : elle réutilise les valeurs disponibles
+    //  (le calcul de chacune est alors sorti, dans un temporaire, de l'affectation qui l'a calculée la première)
+    //  et rend disponibles les siennes ; une instruction qui n'est ni une affectation ni ecrire les oublie toutes
+
+    // Boucles : entre entrerBoucle et sortirBoucle, les invariants sont calculés avant la boucle
+    void entrerBoucle(const Noeud* boucle); // La boucle dont on va optimiser les fils (ce qu'elle écrit est variable)
+    Noeud* sortirBoucle(Noeud* boucle); // Renvoie boucle, précédée des calculs de ses invariants s'il y en a
+    Noeud* calculerBoucle(Noeud* boucle, Noeud* affecter, Noeud* condition, Noeud* sequence, Noeud* action);
+    // Renvoie le noeud qui calcule l'effet de la boucle optimisée sans l'itérer (voir NoeudBoucleCalculee),
+    //  ou nullptr si elle n'est pas de cette forme ; affecter et action peuvent être absents
+
+    // Ce que l'on sait des variables au point du parcours où l'on est
+    void definir(const Noeud* variable, Noeud* valeur = nullptr);
+    // variable (si c'en est une) est définie à partir d'ici, par l'expression valeur si elle est connue
+    void supposer(Noeud* condition); // condition est vraie ici (au début d'une branche, d'un tour de boucle)
+    void bornerCompteur(Noeud* sequence, Noeud* action); // Borne le compteur au début de la séquence d'une boucle pour
+    void restreindre(Etat & communes) const; // Ne garde dans communes que ce qui est aussi vrai ici
+    Noeud* lire(NoeudVariable* variable); // Renvoie le noeud qui lit variable ici : sans vérification si elle est définie
+    Intervalle intervalle(Noeud* expression) const; // Les valeurs que peut prendre expression ici
+    bool diviseurNonNul(CodeSymbole operateur, Noeud* droit) const; // indique si c'est une division par droit, non nul ici
+
+    inline Etat getEtat() const {
+        return Etat{m_definies, m_intervalles};
+    } // accesseur
+
+    inline void setEtat(const Etat & etat) {
+        m_definies = etat.definies;
+        m_intervalles = etat.intervalles;
+    } // Revient à un état antérieur (après une branche qui n'est pas toujours exécutée)
+
+    Noeud* operation(const Symbole & operateur, Noeud* gauche, Noeud* droit); // Crée une opération binaire spécialisée
+    Noeud* affectation(Noeud* variable, Noeud* expression); // Crée une affectation, fusionnée si possible (voir Operations.h)
+    Noeud* entier(int valeur); // Crée la feuille de l'entier valeur
+    Noeud* sequenceVide(); // Crée une séquence sans instruction (ce qui reste d'une instruction supprimée)
+
+    static bool estConstante(Noeud* noeud, int & valeur); // indique si noeud est un entier littéral, de valeur valeur
+    static bool estBooleen(Noeud* noeud); // indique si la valeur de noeud est toujours 0 ou 1
+    bool estSur(Noeud* noeud) const; // indique si l'évaluation de noeud, ici, ne peut pas lever d'exception
+
+    inline void compter(Transformation transformation) {
+        m_compteurs[transformation]++;
+    } // Compte une transformation faite
+
+    inline Arene & getArene() {
+        return m_arene;
+    } // accesseur
+
+    friend ostream & operator<<(ostream & cout, const Optimiseur & optimiseur); // Affiche les statistiques
+    void avertir(ostream & sortie) const; // Affiche les variables lues alors qu'elles ne peuvent pas être définies
+
+private:
+    struct Boucle {
+        vector<bool> ecrites; // Les variables écrites dans la boucle
+        vector<bool> definies; // Les variables sûrement définies avant la boucle
+        vector<Intervalle> intervalles; // Leurs valeurs possibles avant la boucle
+        vector<Noeud*> invariants; // Les affectations des temporaires, à exécuter avant la boucle
+    }; // Une boucle en cours d'optimisation
+
+    Cadre & m_cadre; // Le cadre des variables de l'arbre
+    Arene & m_arene; // L'arène où sont créés les nouveaux noeuds
+    vector<bool> m_definies; // Les variables sûrement définies au point courant du parcours
+    vector<bool> m_peutEtreDefinies; // Celles qui peuvent l'être (sur un chemin déjà parcouru, ou par une boucle)
+    vector<NoeudVariableDefinie*> m_lectures; // La lecture sans vérification de chaque case, créée à la demande
+    vector<unsigned int> m_indefinies; // Les variables lues alors qu'elles ne peuvent pas être définies
+    vector<Intervalle> m_intervalles; // Les valeurs possibles de chaque variable au point courant
+    vector<string> m_verifications; // Les vérifications supprimées grâce aux intervalles, pour les statistiques
+    vector<Boucle> m_boucles; // Les boucles qui contiennent le point courant, de la plus externe à la plus interne
+    unsigned int m_nbTemporaires; // Nombre de variables temporaires créées
+    unsigned int m_compteurs[NB_TRANSFORMATIONS]; // Nombre de transformations de chaque sorte
+    unsigned int m_noeudsAvant; // Nombre de noeuds de l'arbre avant l'optimisation
+    unsigned int m_noeudsApres; // Et après
+
+    Noeud* sortirInvariants(Noeud* expression); // Remplace chaque plus grande sous-expression invariante par un temporaire
+    void borner(unsigned int numeroCase, Intervalle intervalle); // La variable de la case numeroCase est dans intervalle
+    void noter(Transformation transformation, const string & description); // Compte une vérification supprimée
+    Noeud* partager(Noeud* expression, vector<Noeud*> & instructions, vector<bool> & sures, vector<Disponible> & disponibles);
+    // Remplace dans expression les valeurs disponibles par la lecture de leur temporaire
+    void rendreDisponibles(Noeud* expression, size_t instruction, const vector<bool> & ecrites, vector<Disponible> & disponibles) const;
+    // Ajoute les opérations sûres d'expression qui ne lisent aucune des variables ecrites
+    Noeud* reconstruire(Noeud* expression, const function<Noeud*(Noeud*)> & transformer);
+    // L'opération expression, dont chaque opérande f est remplacé par transformer(f) (elle-même si rien ne change)
+};
+
+#endif /* OPTIMISEUR_H */
@@ -0,0 +1,78 @@
+#include "Source.h"
+#include "Exceptions.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <iterator>
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+Source::Source(const string & nomFichier) :
+m_debut(nullptr), m_taille(0), m_projection(nullptr), m_contenu() {
+  int descripteur = open(nomFichier.c_str(), O_RDONLY);
+  if (descripteur < 0) // si le fichier ne peut-être lu...
+    throw FichierException();
+  struct stat infos;
+  if (fstat(descripteur, &infos) == 0 && S_ISREG(infos.st_mode) && infos.st_size > 0) {
+    void * projection = mmap(nullptr, infos.st_size, PROT_READ, MAP_PRIVATE, descripteur, 0);
+    if (projection != MAP_FAILED) {
+      madvise(projection, infos.st_size, MADV_SEQUENTIAL); // le lecteur parcourt le texte du début à la fin
+      m_projection = projection;
+      m_debut = (const char *) projection;
+      m_taille = infos.st_size;
+    }
+  }
+  if (m_projection == nullptr) // fichier vide, tube, ou projection impossible : on lit d'un bloc
+    lireDescripteur(descripteur);
+  close(descripteur);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Source::Source(istream & flux) :
+m_debut(nullptr), m_taille(0), m_projection(nullptr), m_contenu() {
+  if (flux.fail()) // si le flux ne peut-être lu...
+    throw FichierException();
+  m_contenu.assign(istreambuf_iterator<char>(flux), istreambuf_iterator<char>());
+  m_debut = m_contenu.data();
+  m_taille = m_contenu.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Source::Source(const char * tampon, size_t taille) :
+m_debut(tampon), m_taille(taille), m_projection(nullptr), m_contenu() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Source::Source(Source && autre) :
+m_debut(autre.m_debut), m_taille(autre.m_taille), m_projection(autre.m_projection), m_contenu() {
+  if (autre.m_debut == autre.m_contenu.data()) { // le texte est dans la copie : on la déplace avec lui
+    m_contenu = move(autre.m_contenu);
+    m_debut = m_contenu.data();
+  }
+  autre.m_projection = nullptr;
+  autre.m_debut = nullptr;
+  autre.m_taille = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Source::~Source() {
+  if (m_projection != nullptr)
+    munmap(m_projection, m_taille);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Source::lireDescripteur(int descripteur) {
+  char bloc[65536];
+  ssize_t lus;
+  while ((lus = read(descripteur, bloc, sizeof (bloc))) > 0)
+    m_contenu.insert(m_contenu.end(), bloc, bloc + lus);
+  m_debut = m_contenu.data();
+  m_taille = m_contenu.size();
+}
@@ -0,0 +1,45 @@
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Source représente le texte complet d'un programme, accessible comme un tampon contigu de caractères.
+// Le fichier est projeté en mémoire (mmap) quand c'est possible, sinon il est lu d'un seul bloc :
+// le lecteur n'a plus qu'à faire avancer un pointeur, sans aucun appel au flux par caractère.
+
+class Source {
+public:
+    Source(const string & nomFichier); // Projette le fichier en mémoire, ou le lit d'un bloc si la projection échoue
+    Source(istream & flux); // Lit tout le flux d'un bloc (fichier déjà ouvert, cin, ...)
+    Source(const char * tampon, size_t taille); // Tampon en mémoire, non copié : il doit vivre plus longtemps que la source
+    Source(Source && autre); // Transfère le tampon (la source ne se copie pas)
+    ~Source(); // Libère la projection ou la copie du fichier
+
+    inline const char * getDebut() const {
+        return m_debut;
+    } // Premier caractère du texte
+
+    inline const char * getFin() const {
+        return m_debut + m_taille;
+    } // Juste après le dernier caractère du texte
+
+    inline size_t getTaille() const {
+        return m_taille;
+    } // Nombre de caractères du texte
+
+private:
+    Source(const Source &) = delete;
+    Source & operator=(const Source &) = delete;
+
+    const char * m_debut; // Début du texte (dans la projection, dans m_contenu ou dans un tampon externe)
+    size_t m_taille; // Taille du texte
+    void * m_projection; // Adresse de la projection mmap, nullptr si le texte n'est pas projeté
+    vector<char> m_contenu; // Copie du texte quand il a été lu d'un bloc
+    void lireDescripteur(int descripteur); // Lit d'un bloc tout ce que contient le descripteur dans m_contenu
+};
+
+#endif /* SOURCE_H */
@@ -1,21 +1,44 @@
 #include <ctype.h>
 #include <stdlib.h>
 #include <iostream>
-#include <fstream>
 using namespace std;
 
 #include "Symbole.h"
+#include "MotsCles.h"
 
-const char * Symbole::FICHIER_MOTS_CLES = "motsCles.txt";
+// Nom de chaque code (indicé par CodeSymbole)
+static constexpr const char * NOMS_CODES[NB_CODES_SYMBOLE] = {
+  "procedure", "principale", "finproc", "pour", "finpour", "si", "sinon", "sinonsi", "finsi",
+  "tantque", "fintantque", "repeter", "jusqua", "lire", "ecrire",
+  ";", ",", "=", "(", ")",
+  "+", "++", "-", "--", "*", "/",
+  "==", "!=", "<", "<=", ">", ">=",
+  "et", "ou", "non",
+  "<VARIABLE>", "<ENTIER>", "<CHAINE>", "<INDEFINI>", "<FINDEFICHIER>"
+};
 
-Symbole::Symbole(const string & s) : m_chaine(s) {
+// Les mots clés de CodeSymbole doivent être ceux de motsCles.txt, dans le même ordre :
+// le code d'un mot clé est alors directement son indice dans la table générée
+static constexpr bool codesConformesAuxMotsCles() {
+  for (unsigned int i = 0; i < MotsCles::NB_MOTS_CLES; i++)
+    if (string_view(NOMS_CODES[i]) != MotsCles::MOTS[i]) return false;
+  return MotsCles::NB_MOTS_CLES == S_VARIABLE;
+}
+static_assert(codesConformesAuxMotsCles(), "CodeSymbole ne correspond pas à motsCles.txt");
+
+Symbole::Symbole(string_view s) : m_chaine(s) {
+  int motCle;
   // attention : l'ordre des tests ci-dessous n'est pas innocent !
-  if (s == "") this->m_categorie = FINDEFICHIER;
-  else if (isdigit(s[0])) this->m_categorie = ENTIER;
-  else if (s.size() >= 2 && s[0] == '"' && s[s.size() - 1] == '"') this->m_categorie = CHAINE;
-  else if (isMotCle(s)) this->m_categorie = MOTCLE;
-  else if (isalpha(s[0])) this->m_categorie = VARIABLE;
-  else this->m_categorie = INDEFINI;
+  if (s == "") { this->m_categorie = FINDEFICHIER; this->m_code = S_FINDEFICHIER; }
+  else if (isdigit(s[0])) { this->m_categorie = ENTIER; this->m_code = S_ENTIER; }
+  else if (s.size() >= 2 && s[0] == '"' && s[s.size() - 1] == '"') { this->m_categorie = CHAINE; this->m_code = S_CHAINE; }
+  else if ((motCle = MotsCles::chercher(s)) >= 0) { this->m_categorie = MOTCLE; this->m_code = (CodeSymbole) motCle; }
+  else if (isalpha(s[0])) { this->m_categorie = VARIABLE; this->m_code = S_VARIABLE; }
+  else { this->m_categorie = INDEFINI; this->m_code = S_INDEFINI; }
+}
+
+const char * Symbole::getNom(CodeSymbole code) {
+  return NOMS_CODES[code];
 }
 
 bool Symbole::operator==(const string & ch) const {
@@ -27,29 +50,6 @@ bool Symbole::operator==(const string & ch) const {
           (this->m_categorie == FINDEFICHIER && (ch == "<FINDEFICHIER>" || ch == "<findefichier>"));
 }
 
-bool Symbole::isMotCle(const string & s) const {
-  static vector<string> motsCles;
-  // si on n'a pas encore chargé les mots clés dans le vecteur, on le fait !
-  if (!motsCles.size()) {
-    ifstream fichier(FICHIER_MOTS_CLES);
-    while (!fichier.eof()) {
-      string mot;
-      getline(fichier, mot);
-      if (mot != "") { // insertion triée de mot dans le vecteur des mots clés
-        vector<string>::iterator it = motsCles.begin();
-        while (it < motsCles.end() && *it < mot) it++;
-        if (it == motsCles.end() || *it != mot) // si pas trouvé...
-          motsCles.insert(it, mot);
-      }
-    }
-    fichier.close();
-  }
-  // on recherche  s dans le vecteur des mots clés triés
-  unsigned int i;
-  for (i = 0; i < motsCles.size() && motsCles[i] < s; i++);
-  return (i < motsCles.size() && motsCles[i] == s);
-}
-
 ostream & operator<<(ostream & cout, const Symbole & symbole) {
   cout << "Symbole de type ";
   if (symbole.m_categorie == Symbole::MOTCLE) cout << "<MOTCLE>      ";
@@ -4,23 +4,45 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
 using namespace std;
 
+// Code d'un symbole : un par mot clé, opérateur et catégorie de symbole.
+// Il est attribué une seule fois, à la lecture, pour que l'analyseur aiguille sur un entier
+// (switch) au lieu de comparer des chaînes. Les mots clés sont dans l'ordre de motsCles.txt
+// (vérifié à la compilation contre la table générée MotsCles.h).
+enum CodeSymbole {
+	S_PROCEDURE, S_PRINCIPALE, S_FINPROC, S_POUR, S_FINPOUR, S_SI, S_SINON, S_SINONSI, S_FINSI,
+	S_TANTQUE, S_FINTANTQUE, S_REPETER, S_JUSQUA, S_LIRE, S_ECRIRE,
+	S_POINTVIRGULE, S_VIRGULE, S_AFFECTATION, S_PARENTHESEOUVRANTE, S_PARENTHESEFERMANTE,
+	S_PLUS, S_PLUSPLUS, S_MOINS, S_MOINSMOINS, S_MULTIPLIE, S_DIVISE,
+	S_EGAL, S_DIFFERENT, S_INFERIEUR, S_INFERIEUREGAL, S_SUPERIEUR, S_SUPERIEUREGAL,
+	S_ET, S_OU, S_NON,
+	S_VARIABLE, S_ENTIER, S_CHAINE, S_INDEFINI, S_FINDEFICHIER,
+	NB_CODES_SYMBOLE
+};
+
 // Symbole représente un élément du langage (mot-clé, entier, identificateur de variable, ...)
 class Symbole {
 public:
-	Symbole(const string & s = "");  // Construit le symbole à partir de la chaine (string) ch lue par le lecteur de symbole dans un fichier
+	Symbole(string_view s = "");  // Construit le symbole à partir de la chaine s lue par le lecteur de symbole dans un fichier
+	                              // (s n'est pas copiée : elle désigne une tranche du texte source)
 	bool operator == (const string & ch) const ; // Pour tester l'égalité entre le symbole et une chaîne
+	                                             //  (compatibilité : l'analyseur compare plutôt getCode())
 	inline bool operator != (const string  & ch) const { return ! (*this == ch); } // Pour tester la différence...
-	inline const string & getChaine() const { return m_chaine;} // Accesseur
+	inline string_view getChaine() const { return m_chaine;} // Accesseur
+	inline CodeSymbole getCode() const { return m_code;} // Accesseur
+	static const char * getNom(CodeSymbole code); // Chaîne d'un mot clé, ou nom d'une catégorie ("<VARIABLE>"...)
 	friend ostream & operator <<(ostream & cout, const Symbole & symbole); // Fonction amie pour pouvoir afficher un symbole sur cout 
 
+protected:
+	inline void setChaine(string_view s) { m_chaine = s; } // Fait désigner au symbole une autre copie de sa chaîne
+
 private:
     	enum m_categorie { MOTCLE, VARIABLE, ENTIER, CHAINE, INDEFINI, FINDEFICHIER };
-	string           m_chaine;             // Chaîne du symbole
+	string_view      m_chaine;             // Chaîne du symbole (tranche du texte source, sans allocation)
 	m_categorie      m_categorie;          // Categorie du symbole (voir type énuméré ci-dessus)
-	bool             isMotCle(const string & s) const;  // Renvoie vrai si s est un mot clé du langage
-        static const char * FICHIER_MOTS_CLES; // Le fichier des mots clés du langage
+	CodeSymbole      m_code;               // Code du symbole (voir type énuméré CodeSymbole)
 };
 
 #endif /* SYMBOLE_H */
@@ -1,25 +1,44 @@
 #include "SymboleValue.h"
 #include "Exceptions.h"
-#include <stdlib.h>
 
 SymboleValue::SymboleValue(const Symbole & s) :
-Symbole(s.getChaine()) {
-  if (s == "<ENTIER>") {
-    m_valeur = atoi(s.getChaine().c_str()); // c_str convertit une string en char*
-    m_defini = true;
-  } else {
-    m_defini = false;
-  }
+Symbole(s), Noeud(Genre::SYMBOLE), m_texte(s.getChaine()), m_defini(false), m_valeur(0), m_cadre(nullptr), m_case(0), m_noeud(nullptr) {
+  setChaine(m_texte); // le symbole désigne désormais sa propre copie de la chaîne
+  // (les entiers et les chaînes littéraux sont dans la table des littéraux : un symbole valué est une variable)
 }
 
 int SymboleValue::executer() {
+  if (m_cadre != nullptr) return m_cadre->getValeur(m_case);
   if (!m_defini) throw IndefiniException(); // on lève une exception si valeur non définie
   return m_valeur;
 }
 
+void SymboleValue::setValeur(int valeur) {
+  if (m_cadre != nullptr) m_cadre->setValeur(m_case, valeur);
+  else {
+    m_valeur = valeur;
+    m_defini = true;
+  }
+}
+
+bool SymboleValue::estDefini() const {
+  return m_cadre != nullptr ? m_cadre->estDefini(m_case) : m_defini;
+}
+
+Noeud* SymboleValue::resoudre(Cadre & cadre, Arene & arene) {
+  if (m_noeud == nullptr) { // première occurrence : la variable reçoit sa case, avec sa valeur éventuelle
+    m_case = cadre.ajouterCase(getChaine());
+    if (m_defini) cadre.setValeur(m_case, m_valeur);
+    m_cadre = &cadre;
+    m_noeud = arene.creer<NoeudVariable>(cadre, m_case);
+  }
+  return m_noeud;
+}
+
 ostream & operator<<(ostream & cout, const SymboleValue & symbole) {
   cout << (Symbole) symbole << "\t\t - Valeur=";
-  if (symbole.m_defini) cout << symbole.m_valeur << " ";
+  if (symbole.estDefini())
+    cout << (symbole.m_cadre != nullptr ? symbole.m_cadre->getValeur(symbole.m_case) : symbole.m_valeur) << " ";
   else cout << "indefinie ";
   return cout;
 }
@@ -27,4 +46,3 @@ ostream & operator<<(ostream & cout, const SymboleValue & symbole) {
 void SymboleValue::traduitEnCPP(std::ostream& sortie, unsigned int indentation) const {
     sortie << this->getChaine();
 }
-
@@ -12,18 +12,27 @@ class SymboleValue : public Symbole,  // Un symbole valué est un symbole qui a
                      public Noeud  {  //  et c'est aussi une feuille de l'arbre abstrait
 public:
 	  SymboleValue(const Symbole & s); // Construit un symbole valué à partir d'un symbole existant s
+	                                   //  (la chaîne de s est copiée : le symbole valué ne dépend plus du texte source)
+	  SymboleValue(const SymboleValue &) = delete; // la chaîne désignée est celle de m_texte
 	  ~SymboleValue( ) {}
 	  int  executer();         // exécute le SymboleValue (revoie sa valeur !)
-	  inline void setValeur(int valeur)    { this->m_valeur=valeur; m_defini=true;  } // accesseur
-	  inline bool estDefini()              { return m_defini;                       } // accesseur
+	  void setValeur(int valeur);          // accesseur (dans la case du cadre si le symbole est une variable résolue)
+	  bool estDefini() const;              // accesseur
+	  inline void affecter(int valeur) override { setValeur(valeur); } // affectation avant résolution
+	  Noeud* resoudre(Cadre & cadre, Arene & arene) override; // Pour une variable : lui attribue une case de cadre (une seule fois)
+	                                           //  et renvoie la feuille NoeudVariable qui la désigne
           void traduitEnCPP(std::ostream & sortie, unsigned int indentation) const;
 
 
 	  friend ostream & operator << (ostream & cout, const SymboleValue & symbole); // affiche un symbole value sur cout
 
 private:
+	  string m_texte;	// copie de la chaîne du symbole, seule allocation faite pour un symbole lu
 	  bool m_defini;	// indique si la valeur du symbole est définie
 	  int  m_valeur;	// valeur du symbole si elle est définie, zéro sinon
+	  Cadre* m_cadre;	// cadre qui contient la valeur d'une variable résolue, nullptr avant la résolution
+	  unsigned int m_case;	// numéro de la case de la variable dans m_cadre
+	  NoeudVariable* m_noeud;	// feuille partagée par toutes les occurrences résolues de la variable
 
 };
 
@@ -0,0 +1,31 @@
+#include "TableExpressions.h"
+
+TableExpressions::TableExpressions(Arene & arene) : m_arene(arene), m_operations() {
+}
+
+void TableExpressions::vider() {
+  m_operations.clear();
+}
+
+size_t TableExpressions::Hachage::operator()(const Cle & cle) const {
+  uint64_t h = (uint64_t) cle.operateur;
+  h = h * 0x9e3779b97f4a7c15u ^ (uint64_t) (uintptr_t) cle.gauche;
+  h = h * 0x9e3779b97f4a7c15u ^ (uint64_t) (uintptr_t) cle.droit;
+  return (size_t) (h ^ (h >> 29));
+}
+
+Noeud* TableExpressions::chercheAjoute(const Symbole & operateur, Noeud* gauche, Noeud* droit) {
+  Noeud* & operation = m_operations[Cle{operateur.getCode(), gauche, droit}];
+  if (operation != nullptr) return operation; // déjà construite : partagée
+  if (operateur.getCode() == S_ET || operateur.getCode() == S_OU) // l'opérande droit n'est évalué qu'au besoin
+    operation = m_arene.creer<NoeudOperateurLogique>(operateur, gauche, droit);
+  else
+    operation = m_arene.creer<NoeudOperateurBinaire>(operateur, gauche, droit);
+  return operation;
+}
+
+Noeud* TableExpressions::chercheAjoute(const Symbole & operateur, Noeud* operande) {
+  Noeud* & operation = m_operations[Cle{operateur.getCode(), operande, nullptr}];
+  if (operation == nullptr) operation = m_arene.creer<NoeudOperateurUnaire>(operateur, operande);
+  return operation;
+}
@@ -0,0 +1,51 @@
+#ifndef TABLEEXPRESSIONS_H
+#define TABLEEXPRESSIONS_H
+
+#include "ArbreAbstrait.h"
+#include "Arene.h"
+#include "Symbole.h"
+#include <cstdint>
+#include <unordered_map>
+using namespace std;
+
+// La table des expressions partage les opérations identiques du programme (hash-consing) : une opération
+// dont l'opérateur et les opérandes ont déjà été rencontrés n'est construite qu'une fois, à l'analyse,
+// et son noeud est partagé par toutes ses occurrences. Les opérandes sont eux-mêmes partagés (variables
+// de la table des symboles, littéraux de la table des littéraux, opérations de cette table) : deux
+// opérations sont identiques si elles ont le même opérateur et les mêmes noeuds pour opérandes.
+// Une expression n'a pas d'effet de bord et n'est jamais modifiée en place une fois résolue (voir
+// NoeudOperateurBinaire::resoudre) : l'arbre abstrait devient un graphe sans cycle, et seules les
+// instructions restent propres à leur occurrence.
+
+class TableExpressions {
+public:
+    TableExpressions(Arene & arene); // Construit une table vide, dont les noeuds seront créés dans arene
+    void vider(); // Oublie toutes les opérations (avant de vider l'arène qui les contient)
+
+    Noeud* chercheAjoute(const Symbole & operateur, Noeud* gauche, Noeud* droit);
+    // Opération binaire gauche operateur droit (logique pour et et ou)
+    Noeud* chercheAjoute(const Symbole & operateur, Noeud* operande); // Opération unaire operateur operande
+
+private:
+    TableExpressions(const TableExpressions &) = delete;
+    TableExpressions & operator=(const TableExpressions &) = delete;
+
+    struct Cle {
+        CodeSymbole operateur;
+        Noeud* gauche;
+        Noeud* droit; // nullptr pour une opération unaire
+
+        inline bool operator==(const Cle & autre) const {
+            return operateur == autre.operateur && gauche == autre.gauche && droit == autre.droit;
+        }
+    }; // Ce qui identifie une opération
+
+    struct Hachage {
+        size_t operator()(const Cle & cle) const;
+    }; // Mélange l'opérateur et les adresses des opérandes
+
+    Arene & m_arene; // L'arène où sont créés les noeuds
+    unordered_map<Cle, Noeud*, Hachage> m_operations; // Les opérations déjà construites
+};
+
+#endif /* TABLEEXPRESSIONS_H */
@@ -0,0 +1,30 @@
+#include "TableLitteraux.h"
+
+TableLitteraux::TableLitteraux(Arene & arene) : m_arene(arene), m_entiers(), m_chaines() {
+}
+
+void TableLitteraux::vider() {
+  m_entiers.clear();
+  m_chaines.clear();
+}
+
+NoeudEntier* TableLitteraux::chercheAjouteEntier(const Symbole & entier) {
+  unsigned int valeur = 0; // calcul modulo 2^32 : un entier trop grand déborde sans erreur
+  for (char chiffre : entier.getChaine())
+    valeur = valeur * 10 + (chiffre - '0');
+  return chercheAjouteEntier((int) valeur);
+}
+
+NoeudEntier* TableLitteraux::chercheAjouteEntier(int valeur) {
+  NoeudEntier* & feuille = m_entiers[valeur];
+  if (feuille == nullptr) feuille = m_arene.creer<NoeudEntier>(valeur); // pas trouvé : on l'ajoute
+  return feuille;
+}
+
+NoeudChaine* TableLitteraux::chercheAjouteChaine(const Symbole & chaine) {
+  string_view texte = chaine.getChaine();
+  texte = texte.substr(1, texte.size() - 2); // on retire les guillemets
+  NoeudChaine* & feuille = m_chaines[string(texte)];
+  if (feuille == nullptr) feuille = m_arene.creer<NoeudChaine>(texte); // pas trouvé : on l'ajoute
+  return feuille;
+}
@@ -0,0 +1,34 @@
+#ifndef TABLELITTERAUX_H
+#define TABLELITTERAUX_H
+
+#include "ArbreAbstrait.h"
+#include "Arene.h"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+using namespace std;
+
+// La table des littéraux rassemble les constantes du programme (entiers et chaînes), à part des variables.
+// Chaque littéral est converti une seule fois, à l'analyse, en une feuille de valeur immédiate
+// (NoeudEntier, NoeudChaine) partagée par toutes ses occurrences : la table des symboles ne contient
+// plus que les variables.
+
+class TableLitteraux {
+public:
+    TableLitteraux(Arene & arene); // Construit une table de littéraux vide, dont les feuilles seront créées dans arene
+    void vider(); // Oublie toutes les feuilles (avant de vider l'arène qui les contient)
+
+    NoeudEntier* chercheAjouteEntier(const Symbole & entier); // Feuille de l'entier lu (chaîne de chiffres)
+    NoeudEntier* chercheAjouteEntier(int valeur); // Feuille de l'entier valeur
+    NoeudChaine* chercheAjouteChaine(const Symbole & chaine); // Feuille de la chaîne lue, sans ses guillemets
+
+private:
+    TableLitteraux(const TableLitteraux &) = delete;
+    TableLitteraux & operator=(const TableLitteraux &) = delete;
+
+    Arene & m_arene; // L'arène où sont créées les feuilles
+    unordered_map<int, NoeudEntier*> m_entiers; // Les entiers, indexés par leur valeur
+    unordered_map<string, NoeudChaine*> m_chaines; // Les chaînes, indexées par leur texte sans guillemets
+};
+
+#endif /* TABLELITTERAUX_H */
@@ -1,6 +1,16 @@
 #include "TableSymboles.h"
+#include "Hachage.h"
+#include <algorithm>
 
-TableSymboles::TableSymboles() : m_table() {
+TableSymboles::TableSymboles(Arene & arene) :
+m_arene(arene), m_symboles(), m_index(16, 0), m_vueTriee(), m_vueAJour(true) {
+}
+
+void TableSymboles::vider() {
+  m_symboles.clear();
+  m_index.assign(16, 0);
+  m_vueTriee.clear();
+  m_vueAJour = true;
 }
 
 SymboleValue * TableSymboles::chercheAjoute(const Symbole & s)
@@ -9,12 +19,41 @@ SymboleValue * TableSymboles::chercheAjoute(const Symbole & s)
 // Sinon, on insère un nouveau symbole valué correspondant à s
 // et on renvoie un pointeur sur le nouveau symbole valué inséré.
 {
-  vector<SymboleValue*>::iterator i;
-  i = m_table.begin();
-  while (i < m_table.end() && (**i).getChaine() < s.getChaine()) i++;
-  if (i == m_table.end() || (**i).getChaine() != s.getChaine()) // si pas trouvé...
-    i = m_table.insert(i, new SymboleValue(s));
-  return *i;
+  string_view chaine = s.getChaine();
+  size_t masque = m_index.size() - 1;
+  size_t alveole = hacher(chaine) & masque;
+  while (m_index[alveole] != 0) { // on sonde les alvéoles suivantes jusqu'à une alvéole libre
+    SymboleValue * present = m_symboles[m_index[alveole] - 1];
+    if (present->getChaine() == chaine) return present; // trouvé
+    alveole = (alveole + 1) & masque;
+  }
+  SymboleValue * nouveau = m_arene.creer<SymboleValue>(s); // pas trouvé : on l'ajoute à la fin
+  m_symboles.push_back(nouveau);
+  m_index[alveole] = m_symboles.size();
+  m_vueAJour = false;
+  if (m_symboles.size() * 2 > m_index.size()) agrandirIndex();
+  return nouveau;
+}
+
+void TableSymboles::agrandirIndex() {
+  m_index.assign(m_index.size() * 2, 0);
+  size_t masque = m_index.size() - 1;
+  for (unsigned int i = 0; i < m_symboles.size(); i++) {
+    size_t alveole = hacher(m_symboles[i]->getChaine()) & masque;
+    while (m_index[alveole] != 0) alveole = (alveole + 1) & masque;
+    m_index[alveole] = i + 1;
+  }
+}
+
+const vector<SymboleValue*> & TableSymboles::getVueTriee() const {
+  if (!m_vueAJour) {
+    m_vueTriee = m_symboles;
+    sort(m_vueTriee.begin(), m_vueTriee.end(), [](const SymboleValue * a, const SymboleValue * b) {
+      return a->getChaine() < b->getChaine();
+    });
+    m_vueAJour = true;
+  }
+  return m_vueTriee;
 }
 
 ostream & operator<<(ostream & cout, const TableSymboles & ts)
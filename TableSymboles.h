@@ -2,30 +2,50 @@
 #define TABLESYMBOLES_H
 
 #include "SymboleValue.h"
+#include "Arene.h"
 #include <vector>
 #include <iostream>
 using namespace std;
 
+// Les symboles valués sont rangés dans l'ordre où ils sont rencontrés et ne sont jamais déplacés :
+// un pointeur rendu par chercheAjoute reste valable jusqu'à ce que l'arène qui les contient soit vidée.
+// On les retrouve par un index de hachage à adressage ouvert (sondage linéaire), ce qui rend
+// la recherche et l'ajout en temps constant en moyenne, quel que soit le nombre de symboles.
+// L'ordre alphabétique n'est plus nécessaire qu'à l'affichage : la vue triée est construite à la demande.
+
 class TableSymboles {
 public:
-    TableSymboles(); // Construit une table vide de pointeurs sur des symboles valués
+    TableSymboles(Arene & arene); // Construit une table vide de pointeurs sur des symboles valués,
+    //  qui seront créés dans arene (l'arène en est propriétaire)
     SymboleValue* chercheAjoute(const Symbole & symbole);
     // si symbole est identique à un symbole valué déjà présent dans la table,
     // on renvoie un pointeur sur ce symbole valué
     // Sinon on insère un nouveau symbole valué correspondant à symbole
     // et on renvoie un pointeur sur le nouveau symbole valué inséré
 
+    void vider(); // Oublie tous les symboles (avant de vider l'arène qui les contient)
+
     inline unsigned int getTaille() const {
-        return m_table.size();
+        return m_symboles.size();
     } // Taille de la table des symboles valués
 
     inline const SymboleValue & operator[](unsigned int i) const {
-        return *m_table[i];
-    } // accès au ième SymboleValue de la table
+        return *getVueTriee()[i];
+    } // accès au ième SymboleValue de la table, dans l'ordre alphabétique des chaînes
     friend ostream & operator<<(ostream & cout, const TableSymboles & ts); // affiche ts sur cout
 
 private:
-    vector<SymboleValue*> m_table; // La table des symboles valués, triée sur la chaine
-    // (on aurait dû plus judicieusement utiliser map au lieu de vector)
+    TableSymboles(const TableSymboles &) = delete;
+    TableSymboles & operator=(const TableSymboles &) = delete;
+
+    const vector<SymboleValue*> & getVueTriee() const; // Trie les symboles sur leur chaîne si la vue n'est plus à jour
+    void agrandirIndex(); // Double la taille de l'index et y range à nouveau tous les symboles
+
+    Arene & m_arene; // L'arène où sont créés les symboles valués
+    vector<SymboleValue*> m_symboles; // Les symboles valués, dans l'ordre d'insertion (handles stables)
+    vector<unsigned int> m_index; // Alvéoles de l'index : position dans m_symboles + 1, 0 si l'alvéole est libre
+                                  // (taille puissance de 2, remplie au plus à moitié)
+    mutable vector<SymboleValue*> m_vueTriee; // Les symboles triés sur la chaîne, pour l'affichage
+    mutable bool m_vueAJour; // indique si m_vueTriee correspond encore à m_symboles
 };
 #endif /* TABLESYMBOLES_H */
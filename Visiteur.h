@@ -0,0 +1,72 @@
+#ifndef VISITEUR_H
+#define VISITEUR_H
+
+#include "ArbreAbstrait.h"
+#include "SymboleValue.h"
+
+// Les passes qui traitent chaque genre de noeud à sa façon (analyses de l'optimiseur...) s'écrivent comme
+// des visiteurs : une classe Passe dérive de Visiteur<Passe, Resultat> (CRTP) et définit, pour chaque classe
+// de l'arbre abstrait qui l'intéresse, une méthode visiter<Classe> (visiterNoeudEntier, visiterNoeudVariable...) ;
+// les autres genres vont à sa méthode visiterAutre. visiter(noeud) aiguille sur le genre du noeud (voir
+// GENRES) : ni typeid, ni dynamic_cast, ni méthode virtuelle de plus dans Noeud pour chaque nouvelle passe,
+// et les méthodes de Passe, connues à la compilation, peuvent être mises en ligne.
+// Une forme spécialisée (voir Operations.h) est visitée comme la classe dont elle dérive.
+// Les passes que chaque classe définit elle-même, sans méthode virtuelle, sont aiguillées ainsi : parcourirFils
+// (ci-dessous) et optimiser (voir Optimiseur::optimiserFils).
+
+template <class Passe, class Resultat = void>
+class Visiteur {
+public:
+    Resultat visiter(Noeud* noeud) {
+        switch (noeud->getGenre()) {
+#define X(genre, classe) case Genre::genre: return passe().visiter##classe((classe *) noeud);
+            GENRES(X)
+#undef X
+        }
+        return passe().visiterAutre(noeud); // genre inconnu : impossible
+    } // Appelle la méthode de la passe pour le genre de noeud
+
+#define X(genre, classe) \
+    Resultat visiter##classe(classe * noeud) { return passe().visiterAutre(noeud); }
+    GENRES(X)
+#undef X
+    // Par défaut, un noeud de chaque genre est traité par visiterAutre (que la passe définit s'il lui en faut)
+
+protected:
+    Visiteur() {
+    } // Seule une passe construit un visiteur
+
+private:
+    inline Passe & passe() {
+        return static_cast<Passe &> (*this);
+    } // La passe, dont la classe est connue à la compilation
+};
+
+class ParcoursFils : public Visiteur<ParcoursFils> {
+// La méthode parcourirFils de chaque classe qui a des fils ; une feuille n'en a pas
+public:
+    ParcoursFils(const function<void(Noeud*)> & action) : m_action(action) {
+    }
+
+#define PARCOURIR(classe) \
+    void visiter##classe(classe * noeud) { \
+        noeud->parcourirFils(m_action); \
+    }
+    PARCOURIR(NoeudSeqInst) PARCOURIR(NoeudAffectation) PARCOURIR(NoeudOperateurBinaire) PARCOURIR(NoeudOperateurLogique)
+    PARCOURIR(NoeudOperateurUnaire) PARCOURIR(NoeudInstSi) PARCOURIR(NoeudInstTantQue) PARCOURIR(NoeudInstRepeter)
+    PARCOURIR(NoeudInstPour) PARCOURIR(NoeudBoucleCalculee) PARCOURIR(NoeudInstEcrire) PARCOURIR(NoeudInstSiRiche)
+    PARCOURIR(NoeudInstLire)
+#undef PARCOURIR
+
+    void visiterAutre(Noeud *) {
+    }
+
+private:
+    const function<void(Noeud*)> & m_action; // Ce qui est fait de chaque fils
+};
+
+inline void parcourirFils(const Noeud* noeud, const function<void(Noeud*)> & action) {
+    ParcoursFils(action).visiter(const_cast<Noeud*>(noeud));
+} // Appelle action sur chaque fils de noeud, dans l'ordre d'exécution (analyses de l'optimiseur)
+
+#endif /* VISITEUR_H */
@@ -1,32 +1,121 @@
 #include <iostream>
+#include <stdlib.h>
+#include <string.h>
 using namespace std;
 #include "Interpreteur.h"
+#include "ArbrePlat.h"
+#include "MachineVirtuelle.h"
+#include "Fermetures.h"
+#include "CodeNatif.h"
+#include "CompilateurCPP.h"
 #include "Exceptions.h"
 
+static void usage(const char * programme) {
+  cout << "Usage : " << programme << " [options] nom_fichier_source (- pour l'entrée standard)" << endl
+          << "  -j N : découpe le texte en symboles avec N fils d'exécution (0 : autant que de coeurs)" << endl
+          << "  -plat : exécute et traduit l'arbre aplati (tableau contigu de noeuds) au lieu de l'arbre abstrait" << endl
+          << "  -vm : compile l'arbre aplati pour la machine virtuelle à registres et l'y exécute" << endl
+          << "  -fermetures : compile l'arbre en fermetures (lambdas pré-liées) et les exécute" << endl
+          << "  -jit : traduit le programme de la machine virtuelle en code machine x86-64 et l'exécute" << endl
+          << "  -aot : compile le programme en C++ (exécutable mis en cache) et n'affiche que sa sortie" << endl
+          << "  -O : optimise l'arbre avant de l'exécuter (constantes, identités, branches mortes)" << endl
+          << "  -stats : avec -O, affiche le nombre de transformations faites et de noeuds supprimés" << endl
+          << "  -sortie : n'affiche que la sortie du programme (pas les tables des symboles ni la traduction)" << endl << endl;
+}
+
+static void executerCompile(Source source, unsigned int nbTaches, bool optimiser) {
+  // Mode -aot : l'exécutable en cache est lancé sans analyse ; sinon on le produit, et si le compilateur
+  //  échoue, c'est l'arbre qui exécute le programme. Seule la sortie du programme est affichée.
+  CompilateurCPP compilateur;
+  string cle = compilateur.cle(source) + (optimiser ? "-O" : ""); // l'arbre traduit n'est pas le même
+  if (compilateur.estEnCache(cle)) compilateur.lancer(cle); // ne revient que si le lancement échoue
+  Interpreteur interpreteur(move(source), nbTaches);
+  interpreteur.analyse();
+  if (interpreteur.getArbre() == nullptr) return;
+  if (optimiser) {
+    Optimiseur optimiseur(interpreteur.getCadre(), interpreteur.getArene());
+    interpreteur.optimiser(optimiseur);
+  }
+  ArbrePlat arbrePlat(*interpreteur.getArbre(), interpreteur.getCadre());
+  if (compilateur.compiler(arbrePlat, cle)) compilateur.lancer(cle);
+  interpreteur.getArbre()->executer();
+}
+
 int main(int argc, char* argv[]) {
   string nomFich;
-  if (argc != 2) {
-    cout << "Usage : " << argv[0] << " nom_fichier_source" << endl << endl;
+  unsigned int nbTaches = 1; // lecture des symboles à la demande
+  bool plat = false, vm = false, fermetures = false, jit = false, aot = false; // exécution de l'arbre abstrait
+  bool optimiser = false, statistiques = false, sortie = false;
+  int i;
+  for (i = 1; i < argc && argv[i][0] == '-' && argv[i][1] != '\0'; i++) {
+    if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) nbTaches = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-plat") == 0) plat = true;
+    else if (strcmp(argv[i], "-vm") == 0) vm = true;
+    else if (strcmp(argv[i], "-fermetures") == 0) fermetures = true;
+    else if (strcmp(argv[i], "-jit") == 0) jit = true;
+    else if (strcmp(argv[i], "-aot") == 0) aot = true;
+    else if (strcmp(argv[i], "-O") == 0) optimiser = true;
+    else if (strcmp(argv[i], "-stats") == 0) statistiques = true;
+    else if (strcmp(argv[i], "-sortie") == 0) sortie = true;
+    else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (i != argc - 1) {
+    usage(argv[0]);
     cout << "Entrez le nom du fichier que voulez-vous interpréter : ";
     getline(cin, nomFich);
   } else
-    nomFich = argv[1];
-  ifstream fichier(nomFich.c_str());
+    nomFich = argv[i];
   try {
-    Interpreteur interpreteur(fichier);
+    if (aot) {
+      executerCompile(nomFich == "-" ? Source(cin) : Source(nomFich), nbTaches, optimiser);
+      return 0;
+    }
+    ostream nulle(nullptr); // n'écrit rien
+    ostream & rapport = sortie ? nulle : cout; // ce que l'interpréteur affiche autour de la sortie du programme
+    Interpreteur interpreteur(nomFich == "-" ? Source(cin) : Source(nomFich), nbTaches);
     interpreteur.analyse();
     // Si pas d'exception levée, l'analyse syntaxique a réussi
-    cout << endl << "================ Syntaxe Correcte" << endl;
+    rapport << endl << "================ Syntaxe Correcte" << endl;
+    if (optimiser) {
+      Optimiseur optimiseur(interpreteur.getCadre(), interpreteur.getArene());
+      interpreteur.optimiser(optimiseur);
+      if (statistiques) rapport << endl << "================ Optimisation :" << optimiseur;
+      optimiseur.avertir(rapport); // avant l'exécution, qui échouera sur la première de ces lectures
+    }
     // On affiche le contenu de la table des symboles avant d'exécuter le programme
-    cout << endl << "================ Table des symboles avant exécution : " << interpreteur.getTable();
-    cout << endl << "================ Execution de l'arbre" << endl;
+    rapport << endl << "================ Table des symboles avant exécution : " << interpreteur.getTable();
+    rapport << endl << "================ Execution de l'arbre" << endl;
     // On exécute le programme si l'arbre n'est pas vide
     if (interpreteur.getArbre()!=nullptr) {
+      if (jit) {
+        ArbrePlat arbrePlat(*interpreteur.getArbre(), interpreteur.getCadre());
+        MachineVirtuelle machine(arbrePlat);
+        CodeNatif natif(machine); // si la traduction est impossible, c'est la machine qui exécute
+        natif.executer();
+        arbrePlat.traduitEnCPP(rapport, 0);
+      } else if (vm) {
+        ArbrePlat arbrePlat(*interpreteur.getArbre(), interpreteur.getCadre());
+        MachineVirtuelle machine(arbrePlat);
+        machine.executer();
+        arbrePlat.traduitEnCPP(rapport, 0);
+      } else if (fermetures) {
+        Fermetures programme(*interpreteur.getArbre(), interpreteur.getCadre());
+        programme.executer();
+        interpreteur.getArbre()->traduitEnCPP(rapport, 0);
+      } else if (plat) {
+        ArbrePlat arbrePlat(*interpreteur.getArbre(), interpreteur.getCadre());
+        arbrePlat.executer();
+        arbrePlat.traduitEnCPP(rapport, 0);
+      } else {
         interpreteur.getArbre()->executer();
-        interpreteur.getArbre()->traduitEnCPP(cout, 0);
+        interpreteur.getArbre()->traduitEnCPP(rapport, 0);
+      }
     }
     // Et on vérifie qu'il a fonctionné en regardant comment il a modifié la table des symboles
-    cout << endl << "================ Table des symboles apres exécution : " << interpreteur.getTable();
+    rapport << endl << "================ Table des symboles apres exécution : " << interpreteur.getTable();
   } catch (InterpreteurException & e) {
     cout << e.what() << endl;
   }
@@ -36,10 +36,22 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 # Object Files
 OBJECTFILES= \
 	${OBJECTDIR}/ArbreAbstrait.o \
+	${OBJECTDIR}/ArbrePlat.o \
+	${OBJECTDIR}/Arene.o \
+	${OBJECTDIR}/Cadre.o \
+	${OBJECTDIR}/CodeNatif.o \
+	${OBJECTDIR}/CompilateurCPP.o \
+	${OBJECTDIR}/Fermetures.o \
 	${OBJECTDIR}/Interpreteur.o \
 	${OBJECTDIR}/Lecteur.o \
+	${OBJECTDIR}/MachineVirtuelle.o \
+	${OBJECTDIR}/Operations.o \
+	${OBJECTDIR}/Optimiseur.o \
+	${OBJECTDIR}/Source.o \
 	${OBJECTDIR}/Symbole.o \
 	${OBJECTDIR}/SymboleValue.o \
+	${OBJECTDIR}/TableExpressions.o \
+	${OBJECTDIR}/TableLitteraux.o \
 	${OBJECTDIR}/TableSymboles.o \
 	${OBJECTDIR}/main.o
 
@@ -48,8 +60,8 @@ OBJECTFILES= \
 CFLAGS=
 
 # CC Compiler Flags
-CCFLAGS=
-CXXFLAGS=
+CCFLAGS=-std=c++17
+CXXFLAGS=-std=c++17
 
 # Fortran Compiler Flags
 FFLAGS=
@@ -58,7 +70,7 @@ FFLAGS=
 ASFLAGS=
 
 # Link Libraries and Options
-LDLIBSOPTIONS=
+LDLIBSOPTIONS=-pthread
 
 # Build Targets
 .build-conf: ${BUILD_SUBPROJECTS}
@@ -73,6 +85,36 @@ ${OBJECTDIR}/ArbreAbstrait.o: ArbreAbstrait.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/ArbreAbstrait.o ArbreAbstrait.cpp
 
+${OBJECTDIR}/ArbrePlat.o: ArbrePlat.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/ArbrePlat.o ArbrePlat.cpp
+
+${OBJECTDIR}/Arene.o: Arene.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Arene.o Arene.cpp
+
+${OBJECTDIR}/Cadre.o: Cadre.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Cadre.o Cadre.cpp
+
+${OBJECTDIR}/CodeNatif.o: CodeNatif.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/CodeNatif.o CodeNatif.cpp
+
+${OBJECTDIR}/CompilateurCPP.o: CompilateurCPP.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/CompilateurCPP.o CompilateurCPP.cpp
+
+${OBJECTDIR}/Fermetures.o: Fermetures.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Fermetures.o Fermetures.cpp
+
 ${OBJECTDIR}/Interpreteur.o: Interpreteur.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -83,6 +125,26 @@ ${OBJECTDIR}/Lecteur.o: Lecteur.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Lecteur.o Lecteur.cpp
 
+${OBJECTDIR}/MachineVirtuelle.o: MachineVirtuelle.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/MachineVirtuelle.o MachineVirtuelle.cpp
+
+${OBJECTDIR}/Operations.o: Operations.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Operations.o Operations.cpp
+
+${OBJECTDIR}/Optimiseur.o: Optimiseur.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Optimiseur.o Optimiseur.cpp
+
+${OBJECTDIR}/Source.o: Source.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Source.o Source.cpp
+
 ${OBJECTDIR}/Symbole.o: Symbole.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -93,6 +155,16 @@ ${OBJECTDIR}/SymboleValue.o: SymboleValue.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/SymboleValue.o SymboleValue.cpp
 
+${OBJECTDIR}/TableExpressions.o: TableExpressions.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/TableExpressions.o TableExpressions.cpp
+
+${OBJECTDIR}/TableLitteraux.o: TableLitteraux.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/TableLitteraux.o TableLitteraux.cpp
+
 ${OBJECTDIR}/TableSymboles.o: TableSymboles.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -0,0 +1,32 @@
+#!/bin/sh
+# Mesure le temps d'exécution de boucles pour imbriquées du style de testpour.txt, dont le corps
+# n'est fait que d'opérations binaires sur des variables et des constantes (i < 20, s + i, ...).
+#
+# Usage : outils/benchBoucles.sh [nombre de tours de la boucle externe] exécutable [options] ...
+#   chaque exécutable est suivi de ses options éventuelles, entre guillemets : "dist/Release/GNU-Linux/projet-c- -plat"
+
+TOURS=${1:-20000}
+shift
+[ $# -eq 0 ] && set -- dist/Release/GNU-Linux/projet-c-
+PROGRAMME=$(mktemp)
+trap 'rm -f "$PROGRAMME"' EXIT
+
+cat > "$PROGRAMME" <<FIN
+procedure principale()
+    s = 0;
+    pour (i = 0; i < $TOURS; i = i + 1)
+        pour (j = 0; j < 500; j = j + 1)
+            s = s + j;
+            si (s > 1000000) s = s - 1000000; finsi
+        finpour
+    finpour
+    ecrire(s);
+finproc
+FIN
+
+for COMMANDE in "$@"; do
+  DEBUT=$(date +%s.%N)
+  $COMMANDE "$PROGRAMME" > /dev/null
+  FIN=$(date +%s.%N)
+  echo "$DEBUT $FIN" | awk -v c="$COMMANDE" '{ printf "%8.3f s  %s\n", $2 - $1, c }'
+done
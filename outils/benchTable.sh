@@ -0,0 +1,27 @@
+#!/bin/sh
+# Mesure le temps d'interprétation de programmes contenant N variables et N entiers distincts,
+# pour N doublant à chaque étape : avec une table des symboles en temps constant par symbole,
+# le temps par symbole (dernière colonne) doit rester à peu près stable quand N double.
+#
+# Usage : outils/benchTable.sh [exécutable] [N de départ] [nombre d'étapes]
+
+EXECUTABLE=${1:-dist/Release/GNU-Linux/projet-c-}
+N=${2:-25000}
+ETAPES=${3:-4}
+PROGRAMME=$(mktemp)
+trap 'rm -f "$PROGRAMME"' EXIT
+
+printf "%10s %10s %14s\n" "N" "temps (s)" "us / symbole"
+while [ "$ETAPES" -gt 0 ]; do
+  awk -v n="$N" 'BEGIN {
+    print "procedure principale()";
+    for (i = 0; i < n; i++) printf "    v%d = %d;\n", i, i + 1000000;
+    print "finproc";
+  }' > "$PROGRAMME"
+  DEBUT=$(date +%s.%N)
+  "$EXECUTABLE" "$PROGRAMME" > /dev/null
+  FIN=$(date +%s.%N)
+  echo "$N $DEBUT $FIN" | awk '{ t = $3 - $2; printf "%10d %10.3f %14.3f\n", $1, t, t * 1e6 / (2 * $1) }'
+  N=$((N * 2))
+  ETAPES=$((ETAPES - 1))
+done
@@ -0,0 +1,90 @@
+// Générateur de la table des mots clés (exécuté à la compilation, voir le Makefile)
+//   usage : genMotsCles motsCles.txt > MotsCles.h
+// Lit les mots clés (un par ligne) et cherche une graine pour laquelle la fonction hacher()
+// range chaque mot dans une alvéole différente d'une table de taille puissance de 2 :
+// la reconnaissance d'un mot clé coûte alors un hachage et une seule comparaison.
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../Hachage.h"
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        cerr << "Usage : " << argv[0] << " fichier_mots_cles" << endl;
+        return 1;
+    }
+    ifstream fichier(argv[1]);
+    if (fichier.fail()) {
+        cerr << "Ouverture Fichier Impossible : " << argv[1] << endl;
+        return 1;
+    }
+    vector<string> mots;
+    string mot;
+    while (getline(fichier, mot)) {
+        if (!mot.empty() && mot[mot.size() - 1] == '\r') mot.erase(mot.size() - 1);
+        if (mot == "") continue;
+        for (const string & m : mots)
+            if (m == mot) {
+                cerr << "Mot clé en double : " << mot << endl;
+                return 1;
+            }
+        mots.push_back(mot);
+    }
+
+    if (mots.size() > 127) { // les alvéoles sont des signed char
+        cerr << "Trop de mots clés : " << mots.size() << endl;
+        return 1;
+    }
+
+    // recherche d'une graine sans collision, en agrandissant la table si besoin
+    unsigned int taille = 1;
+    while (taille < 2 * mots.size()) taille *= 2;
+    uint32_t graine = 0;
+    vector<int> alveoles;
+    for (bool trouve = false; !trouve;) {
+        for (graine = 0; graine < 100000 && !trouve; graine++) {
+            alveoles.assign(taille, -1);
+            trouve = true;
+            for (unsigned int i = 0; i < mots.size() && trouve; i++) {
+                int & alveole = alveoles[hacher(mots[i], graine) & (taille - 1)];
+                if (alveole >= 0) trouve = false;
+                else alveole = i;
+            }
+        }
+        if (!trouve) taille *= 2;
+        else graine--;
+    }
+
+    cout << "// Fichier généré par outils/genMotsCles à partir de " << argv[1] << " : ne pas modifier" << endl
+         << "#ifndef MOTSCLES_H" << endl << "#define MOTSCLES_H" << endl << endl
+         << "#include \"Hachage.h\"" << endl << endl
+         << "namespace MotsCles {" << endl << endl
+         << "constexpr unsigned int NB_MOTS_CLES = " << mots.size() << ";" << endl
+         << "constexpr uint32_t GRAINE = " << graine << "u;" << endl
+         << "constexpr unsigned int TAILLE_TABLE = " << taille << "; // puissance de 2" << endl << endl
+         << "constexpr const char * MOTS[NB_MOTS_CLES] = { // dans l'ordre du fichier" << endl;
+    for (unsigned int i = 0; i < mots.size(); i++) {
+        cout << "    \"";
+        for (char c : mots[i]) {
+            if (c == '"' || c == '\\') cout << '\\';
+            cout << c;
+        }
+        cout << "\"," << endl;
+    }
+    cout << "};" << endl << endl
+         << "constexpr signed char ALVEOLES[TAILLE_TABLE] = { // indice du mot rangé dans l'alvéole, -1 si vide";
+    for (unsigned int i = 0; i < taille; i++)
+        cout << (i % 16 ? " " : "\n    ") << alveoles[i] << ",";
+    cout << endl << "};" << endl << endl
+         << "// Indice de s dans MOTS, -1 si s n'est pas un mot clé" << endl
+         << "constexpr int chercher(string_view s) {" << endl
+         << "    int i = ALVEOLES[hacher(s, GRAINE) & (TAILLE_TABLE - 1)];" << endl
+         << "    return (i >= 0 && s == MOTS[i]) ? i : -1;" << endl
+         << "}" << endl << endl
+         << "}" << endl << endl
+         << "#endif /* MOTSCLES_H */" << endl;
+    return 0;
+}
@@ -0,0 +1,31 @@
+#!/bin/sh
+# Vérifie que le mode -aot produit la même sortie que l'interpréteur : pour chaque programme, la sortie
+# de l'exécutable compilé doit être le début de ce que l'interpréteur affiche après "Execution de l'arbre"
+# (il y ajoute ensuite la traduction et la table des symboles). Le cache utilisé est temporaire, et chaque
+# exécution est arrêtée au bout de TEMPS secondes (5 par défaut : testRepeter.txt boucle indéfiniment).
+#
+# Usage : outils/verifierAOT.sh [exécutable] [entrée pour lire] [programmes...]
+#   par défaut : dist/Debug/GNU-Linux/projet-c-, l'entrée "7", et les test*.txt et programme.txt
+
+EXE=${1:-dist/Debug/GNU-Linux/projet-c-}
+ENTREE=${2:-7}
+[ $# -ge 2 ] && shift 2 || shift $#
+[ $# -eq 0 ] && set -- test*.txt programme.txt
+XDG_CACHE_HOME=$(mktemp -d)
+export XDG_CACHE_HOME
+trap 'rm -rf "$XDG_CACHE_HOME"' EXIT
+
+TEMPS=${TEMPS:-5}
+ECHECS=0
+for PROGRAMME in "$@"; do
+  COMPILE=$(echo "$ENTREE" | timeout "$TEMPS" "$EXE" -aot "$PROGRAMME" 2>&1)
+  ARBRE=$(echo "$ENTREE" | timeout "$TEMPS" "$EXE" "$PROGRAMME" 2>&1)
+  case "$ARBRE" in
+    *"================ Execution de l'arbre"*) ARBRE=$(echo "$ARBRE" | sed -n "/^================ Execution de l'arbre/,\$p" | tail -n +2) ;;
+  esac # sinon erreur de syntaxe : les deux modes affichent le même message
+  case "$ARBRE" in
+    "$COMPILE"*) echo "identique  $PROGRAMME" ;;
+    *) echo "DIFFERENT  $PROGRAMME"; ECHECS=$((ECHECS + 1)) ;;
+  esac
+done
+exit $ECHECS
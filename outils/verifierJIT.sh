@@ -0,0 +1,32 @@
+#!/bin/sh
+# Vérifie que le mode -jit produit exactement la même sortie que l'interpréteur : ce qu'écrit le programme,
+# le message d'erreur éventuel (division par zéro, variable indéfinie), la traduction et la table des
+# symboles après exécution, qui montre la valeur finale de chaque variable. Les différences sont affichées.
+# OPTIONS est ajouté aux deux exécutions (OPTIONS=-O : code natif du programme optimisé), et chaque
+# exécution est arrêtée au bout de TEMPS secondes (5 par défaut : testRepeter.txt boucle indéfiniment).
+#
+# Usage : outils/verifierJIT.sh [exécutable] [entrée pour lire] [programmes...]
+#   par défaut : dist/Debug/GNU-Linux/projet-c-, l'entrée "7", et les test*.txt et programme.txt
+
+EXE=${1:-dist/Debug/GNU-Linux/projet-c-}
+ENTREE=${2:-7}
+[ $# -ge 2 ] && shift 2 || shift $#
+[ $# -eq 0 ] && set -- test*.txt programme.txt
+ARBRE=$(mktemp)
+NATIF=$(mktemp)
+trap 'rm -f "$ARBRE" "$NATIF"' EXIT
+
+TEMPS=${TEMPS:-5}
+ECHECS=0
+for PROGRAMME in "$@"; do
+  echo "$ENTREE" | timeout "$TEMPS" "$EXE" $OPTIONS -jit "$PROGRAMME" > "$NATIF" 2>&1
+  echo "$ENTREE" | timeout "$TEMPS" "$EXE" $OPTIONS "$PROGRAMME" > "$ARBRE" 2>&1
+  if cmp -s "$ARBRE" "$NATIF"; then
+    echo "identique  $PROGRAMME"
+  else
+    echo "DIFFERENT  $PROGRAMME"
+    diff "$ARBRE" "$NATIF" | sed 's/^/    /'
+    ECHECS=$((ECHECS + 1))
+  fi
+done
+exit $ECHECS
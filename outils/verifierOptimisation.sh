@@ -0,0 +1,39 @@
+#!/bin/sh
+# Vérifie que l'option -O ne change pas ce que fait un programme : pour chaque programme, la sortie
+# (option -sortie : ce qu'il écrit, puis le message d'erreur éventuel) et la table des symboles après
+# exécution doivent être les mêmes avec et sans -O. Les différences sont affichées. OPTIONS est ajouté
+# aux deux exécutions (OPTIONS=-vm : le programme optimisé exécuté par la machine virtuelle), et chaque
+# exécution est arrêtée au bout de TEMPS secondes (5 par défaut : testRepeter.txt boucle indéfiniment).
+#
+# Usage : outils/verifierOptimisation.sh [exécutable] [entrée pour lire] [programmes...]
+#   par défaut : dist/Debug/GNU-Linux/projet-c-, l'entrée "7", et les test*.txt et programme.txt
+
+EXE=${1:-dist/Debug/GNU-Linux/projet-c-}
+ENTREE=${2:-7}
+[ $# -ge 2 ] && shift 2 || shift $#
+[ $# -eq 0 ] && set -- test*.txt programme.txt
+ARBRE=$(mktemp)
+OPTIMISE=$(mktemp)
+trap 'rm -f "$ARBRE" "$OPTIMISE"' EXIT
+
+# Sortie du programme, puis table des symboles finale (absente si le programme s'est arrêté sur une erreur)
+executer() {
+  echo "$ENTREE" | timeout "$TEMPS" "$EXE" $OPTIONS -sortie "$@" 2>&1
+  echo
+  echo "$ENTREE" | timeout "$TEMPS" "$EXE" $OPTIONS "$@" 2>&1 | sed -n '/^================ Table des symboles apres/,$p'
+}
+
+TEMPS=${TEMPS:-5}
+ECHECS=0
+for PROGRAMME in "$@"; do
+  executer "$PROGRAMME" > "$ARBRE"
+  executer -O "$PROGRAMME" > "$OPTIMISE"
+  if cmp -s "$ARBRE" "$OPTIMISE"; then
+    echo "identique  $PROGRAMME"
+  else
+    echo "DIFFERENT  $PROGRAMME"
+    diff "$ARBRE" "$OPTIMISE" | sed 's/^/    /'
+    ECHECS=$((ECHECS + 1))
+  fi
+done
+exit $ECHECS